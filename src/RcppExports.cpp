@@ -338,6 +338,27 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_region_terms
+List cpp_s2_region_terms(List geog, bool query, CharacterVector prefix, int min_level, int max_level, int max_cells, int level_mod, bool points_only, bool optimize_for_space, std::string marker, int numThreads);
+RcppExport SEXP _s2_cpp_s2_region_terms(SEXP geogSEXP, SEXP querySEXP, SEXP prefixSEXP, SEXP min_levelSEXP, SEXP max_levelSEXP, SEXP max_cellsSEXP, SEXP level_modSEXP, SEXP points_onlySEXP, SEXP optimize_for_spaceSEXP, SEXP markerSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< bool >::type query(querySEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type prefix(prefixSEXP);
+    Rcpp::traits::input_parameter< int >::type min_level(min_levelSEXP);
+    Rcpp::traits::input_parameter< int >::type max_level(max_levelSEXP);
+    Rcpp::traits::input_parameter< int >::type max_cells(max_cellsSEXP);
+    Rcpp::traits::input_parameter< int >::type level_mod(level_modSEXP);
+    Rcpp::traits::input_parameter< bool >::type points_only(points_onlySEXP);
+    Rcpp::traits::input_parameter< bool >::type optimize_for_space(optimize_for_spaceSEXP);
+    Rcpp::traits::input_parameter< std::string >::type marker(markerSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_region_terms(geog, query, prefix, min_level, max_level, max_cells, level_mod, points_only, optimize_for_space, marker, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cpp_s2_cell_sentinel
 NumericVector cpp_s2_cell_sentinel();
 RcppExport SEXP _s2_cpp_s2_cell_sentinel() {
@@ -360,13 +381,14 @@ BEGIN_RCPP
 END_RCPP
 }
 // cpp_s2_cell_from_lnglat
-NumericVector cpp_s2_cell_from_lnglat(List lnglat);
-RcppExport SEXP _s2_cpp_s2_cell_from_lnglat(SEXP lnglatSEXP) {
+NumericVector cpp_s2_cell_from_lnglat(List lnglat, int numThreads);
+RcppExport SEXP _s2_cpp_s2_cell_from_lnglat(SEXP lnglatSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type lnglat(lnglatSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_cell_from_lnglat(lnglat));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_cell_from_lnglat(lnglat, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -739,6 +761,87 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_cell_bin
+List cpp_s2_cell_bin(SEXP x, IntegerVector levels, SEXP weight, int numThreads);
+RcppExport SEXP _s2_cpp_s2_cell_bin(SEXP xSEXP, SEXP levelsSEXP, SEXP weightSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type levels(levelsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_cell_bin(x, levels, weight, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_geog_from_geoarrow
+List cpp_s2_geog_from_geoarrow(SEXP schemaXPtr, SEXP arrayXPtr, bool oriented, bool check, SEXP projectionXPtr, double tessellateTolerance, int numThreads);
+RcppExport SEXP _s2_cpp_s2_geog_from_geoarrow(SEXP schemaXPtrSEXP, SEXP arrayXPtrSEXP, SEXP orientedSEXP, SEXP checkSEXP, SEXP projectionXPtrSEXP, SEXP tessellateToleranceSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type schemaXPtr(schemaXPtrSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type arrayXPtr(arrayXPtrSEXP);
+    Rcpp::traits::input_parameter< bool >::type oriented(orientedSEXP);
+    Rcpp::traits::input_parameter< bool >::type check(checkSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type projectionXPtr(projectionXPtrSEXP);
+    Rcpp::traits::input_parameter< double >::type tessellateTolerance(tessellateToleranceSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geog_from_geoarrow(schemaXPtr, arrayXPtr, oriented, check, projectionXPtr, tessellateTolerance, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_as_geoarrow
+void cpp_s2_as_geoarrow(List geog, int geometryType, bool interleaved, SEXP projectionXPtr, SEXP schemaXPtr, SEXP arrayXPtr);
+RcppExport SEXP _s2_cpp_s2_as_geoarrow(SEXP geogSEXP, SEXP geometryTypeSEXP, SEXP interleavedSEXP, SEXP projectionXPtrSEXP, SEXP schemaXPtrSEXP, SEXP arrayXPtrSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< int >::type geometryType(geometryTypeSEXP);
+    Rcpp::traits::input_parameter< bool >::type interleaved(interleavedSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type projectionXPtr(projectionXPtrSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type schemaXPtr(schemaXPtrSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type arrayXPtr(arrayXPtrSEXP);
+    cpp_s2_as_geoarrow(geog, geometryType, interleaved, projectionXPtr, schemaXPtr, arrayXPtr);
+    return R_NilValue;
+END_RCPP
+}
+// cpp_s2_geography_index
+SEXP cpp_s2_geography_index(List geog, int maxEdgesPerCell);
+RcppExport SEXP _s2_cpp_s2_geography_index(SEXP geogSEXP, SEXP maxEdgesPerCellSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< int >::type maxEdgesPerCell(maxEdgesPerCellSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geography_index(geog, maxEdgesPerCell));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_geography_index_encode
+RawVector cpp_s2_geography_index_encode(List index);
+RcppExport SEXP _s2_cpp_s2_geography_index_encode(SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geography_index_encode(index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_geography_index_decode
+SEXP cpp_s2_geography_index_decode(List geog, RawVector encoded);
+RcppExport SEXP _s2_cpp_s2_geography_index_decode(SEXP geogSEXP, SEXP encodedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< RawVector >::type encoded(encodedSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geography_index_decode(geog, encoded));
+    return rcpp_result_gen;
+END_RCPP
+}
 // s2_geography_full
 List s2_geography_full(LogicalVector x);
 RcppExport SEXP _s2_s2_geography_full(SEXP xSEXP) {
@@ -761,25 +864,111 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_prepare
+void cpp_s2_prepare(List geog, int numThreads);
+RcppExport SEXP _s2_cpp_s2_prepare(SEXP geogSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    cpp_s2_prepare(geog, numThreads);
+    return R_NilValue;
+END_RCPP
+}
+// cpp_s2_prepare_covering
+void cpp_s2_prepare_covering(List geog, int maxCells, double distance, int numThreads);
+RcppExport SEXP _s2_cpp_s2_prepare_covering(SEXP geogSEXP, SEXP maxCellsSEXP, SEXP distanceSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< int >::type maxCells(maxCellsSEXP);
+    Rcpp::traits::input_parameter< double >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    cpp_s2_prepare_covering(geog, maxCells, distance, numThreads);
+    return R_NilValue;
+END_RCPP
+}
+// cpp_s2_join_pairs
+List cpp_s2_join_pairs(List geog1, List geog2, std::string predicate, List s2options, int maxFeatureCells, int numThreads);
+RcppExport SEXP _s2_cpp_s2_join_pairs(SEXP geog1SEXP, SEXP geog2SEXP, SEXP predicateSEXP, SEXP s2optionsSEXP, SEXP maxFeatureCellsSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
+    Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
+    Rcpp::traits::input_parameter< std::string >::type predicate(predicateSEXP);
+    Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
+    Rcpp::traits::input_parameter< int >::type maxFeatureCells(maxFeatureCellsSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_join_pairs(geog1, geog2, predicate, s2options, maxFeatureCells, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_relate_pairs
+List cpp_s2_relate_pairs(List geog1, List geog2, List s2options, int maxFeatureCells, int numThreads);
+RcppExport SEXP _s2_cpp_s2_relate_pairs(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP maxFeatureCellsSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
+    Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
+    Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
+    Rcpp::traits::input_parameter< int >::type maxFeatureCells(maxFeatureCellsSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_relate_pairs(geog1, geog2, s2options, maxFeatureCells, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_knn_join
+List cpp_s2_knn_join(SEXP geog1, List geog2, int k, double maxDistance, int numThreads);
+RcppExport SEXP _s2_cpp_s2_knn_join(SEXP geog1SEXP, SEXP geog2SEXP, SEXP kSEXP, SEXP maxDistanceSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type geog1(geog1SEXP);
+    Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< double >::type maxDistance(maxDistanceSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_knn_join(geog1, geog2, k, maxDistance, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_point_in_polygon_join
+List cpp_s2_point_in_polygon_join(SEXP geog1, List geog2, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_point_in_polygon_join(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type geog1(geog1SEXP);
+    Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
+    Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_point_in_polygon_join(geog1, geog2, s2options, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // s2_lnglat_from_s2_point
-List s2_lnglat_from_s2_point(List s2_point);
-RcppExport SEXP _s2_s2_lnglat_from_s2_point(SEXP s2_pointSEXP) {
+List s2_lnglat_from_s2_point(List s2_point, int numThreads);
+RcppExport SEXP _s2_s2_lnglat_from_s2_point(SEXP s2_pointSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type s2_point(s2_pointSEXP);
-    rcpp_result_gen = Rcpp::wrap(s2_lnglat_from_s2_point(s2_point));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(s2_lnglat_from_s2_point(s2_point, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // s2_point_from_s2_lnglat
-List s2_point_from_s2_lnglat(List s2_lnglat);
-RcppExport SEXP _s2_s2_point_from_s2_lnglat(SEXP s2_lnglatSEXP) {
+List s2_point_from_s2_lnglat(List s2_lnglat, int numThreads);
+RcppExport SEXP _s2_s2_point_from_s2_lnglat(SEXP s2_lnglatSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type s2_lnglat(s2_lnglatSEXP);
-    rcpp_result_gen = Rcpp::wrap(s2_point_from_s2_lnglat(s2_lnglat));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(s2_point_from_s2_lnglat(s2_lnglat, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -823,8 +1012,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // cpp_s2_may_intersect_matrix
-List cpp_s2_may_intersect_matrix(List geog1, List geog2, int maxEdgesPerCell, int maxFeatureCells, List s2options);
-RcppExport SEXP _s2_cpp_s2_may_intersect_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP maxEdgesPerCellSEXP, SEXP maxFeatureCellsSEXP, SEXP s2optionsSEXP) {
+List cpp_s2_may_intersect_matrix(List geog1, List geog2, int maxEdgesPerCell, int maxFeatureCells, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_may_intersect_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP maxEdgesPerCellSEXP, SEXP maxFeatureCellsSEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -833,109 +1022,118 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type maxEdgesPerCell(maxEdgesPerCellSEXP);
     Rcpp::traits::input_parameter< int >::type maxFeatureCells(maxFeatureCellsSEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_may_intersect_matrix(geog1, geog2, maxEdgesPerCell, maxFeatureCells, s2options));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_may_intersect_matrix(geog1, geog2, maxEdgesPerCell, maxFeatureCells, s2options, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_contains_matrix
-List cpp_s2_contains_matrix(List geog1, List geog2, List s2options);
-RcppExport SEXP _s2_cpp_s2_contains_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
+List cpp_s2_contains_matrix(List geog1, List geog2, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_contains_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_contains_matrix(geog1, geog2, s2options));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_contains_matrix(geog1, geog2, s2options, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_within_matrix
-List cpp_s2_within_matrix(List geog1, List geog2, List s2options);
-RcppExport SEXP _s2_cpp_s2_within_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
+List cpp_s2_within_matrix(List geog1, List geog2, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_within_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_within_matrix(geog1, geog2, s2options));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_within_matrix(geog1, geog2, s2options, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_intersects_matrix
-List cpp_s2_intersects_matrix(List geog1, List geog2, List s2options);
-RcppExport SEXP _s2_cpp_s2_intersects_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
+List cpp_s2_intersects_matrix(List geog1, List geog2, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_intersects_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_intersects_matrix(geog1, geog2, s2options));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_intersects_matrix(geog1, geog2, s2options, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_equals_matrix
-List cpp_s2_equals_matrix(List geog1, List geog2, List s2options);
-RcppExport SEXP _s2_cpp_s2_equals_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
+List cpp_s2_equals_matrix(List geog1, List geog2, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_equals_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_equals_matrix(geog1, geog2, s2options));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_equals_matrix(geog1, geog2, s2options, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_touches_matrix
-List cpp_s2_touches_matrix(List geog1, List geog2, List s2options);
-RcppExport SEXP _s2_cpp_s2_touches_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
+List cpp_s2_touches_matrix(List geog1, List geog2, List s2options, int numThreads);
+RcppExport SEXP _s2_cpp_s2_touches_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_touches_matrix(geog1, geog2, s2options));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_touches_matrix(geog1, geog2, s2options, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_dwithin_matrix
-List cpp_s2_dwithin_matrix(List geog1, List geog2, double distance);
-RcppExport SEXP _s2_cpp_s2_dwithin_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP distanceSEXP) {
+List cpp_s2_dwithin_matrix(List geog1, List geog2, double distance, int numThreads);
+RcppExport SEXP _s2_cpp_s2_dwithin_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP distanceSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
     Rcpp::traits::input_parameter< double >::type distance(distanceSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_dwithin_matrix(geog1, geog2, distance));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_dwithin_matrix(geog1, geog2, distance, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_distance_matrix
-NumericMatrix cpp_s2_distance_matrix(List geog1, List geog2);
-RcppExport SEXP _s2_cpp_s2_distance_matrix(SEXP geog1SEXP, SEXP geog2SEXP) {
+NumericMatrix cpp_s2_distance_matrix(List geog1, List geog2, int numThreads);
+RcppExport SEXP _s2_cpp_s2_distance_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_distance_matrix(geog1, geog2));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_distance_matrix(geog1, geog2, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cpp_s2_max_distance_matrix
-NumericMatrix cpp_s2_max_distance_matrix(List geog1, List geog2);
-RcppExport SEXP _s2_cpp_s2_max_distance_matrix(SEXP geog1SEXP, SEXP geog2SEXP) {
+NumericMatrix cpp_s2_max_distance_matrix(List geog1, List geog2, int numThreads);
+RcppExport SEXP _s2_cpp_s2_max_distance_matrix(SEXP geog1SEXP, SEXP geog2SEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
     Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_max_distance_matrix(geog1, geog2));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_max_distance_matrix(geog1, geog2, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1017,6 +1215,20 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_index_query_candidates
+IntegerVector cpp_s2_index_query_candidates(List geog1, List geog2, int maxFeatureCells, bool useSet);
+RcppExport SEXP _s2_cpp_s2_index_query_candidates(SEXP geog1SEXP, SEXP geog2SEXP, SEXP maxFeatureCellsSEXP, SEXP useSetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
+    Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
+    Rcpp::traits::input_parameter< int >::type maxFeatureCells(maxFeatureCellsSEXP);
+    Rcpp::traits::input_parameter< bool >::type useSet(useSetSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_index_query_candidates(geog1, geog2, maxFeatureCells, useSet));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cpp_s2_intersects
 LogicalVector cpp_s2_intersects(List geog1, List geog2, List s2options);
 RcppExport SEXP _s2_cpp_s2_intersects(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
@@ -1069,6 +1281,19 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_relate
+IntegerVector cpp_s2_relate(List geog1, List geog2, List s2options);
+RcppExport SEXP _s2_cpp_s2_relate(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog1(geog1SEXP);
+    Rcpp::traits::input_parameter< List >::type geog2(geog2SEXP);
+    Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_relate(geog1, geog2, s2options));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cpp_s2_dwithin
 LogicalVector cpp_s2_dwithin(List geog1, List geog2, NumericVector distance);
 RcppExport SEXP _s2_cpp_s2_dwithin(SEXP geog1SEXP, SEXP geog2SEXP, SEXP distanceSEXP) {
@@ -1112,6 +1337,30 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_geography_encode
+RawVector cpp_s2_geography_encode(List geog, int numThreads);
+RcppExport SEXP _s2_cpp_s2_geography_encode(SEXP geogSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geography_encode(geog, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_geography_decode
+List cpp_s2_geography_decode(RawVector encoded, int numThreads);
+RcppExport SEXP _s2_cpp_s2_geography_decode(SEXP encodedSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< RawVector >::type encoded(encodedSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geography_decode(encoded, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cpp_s2_intersection
 List cpp_s2_intersection(List geog1, List geog2, List s2options);
 RcppExport SEXP _s2_cpp_s2_intersection(SEXP geog1SEXP, SEXP geog2SEXP, SEXP s2optionsSEXP) {
@@ -1164,6 +1413,16 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_max_memory_usage
+double cpp_s2_max_memory_usage();
+RcppExport SEXP _s2_cpp_s2_max_memory_usage() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_max_memory_usage());
+    return rcpp_result_gen;
+END_RCPP
+}
 // cpp_s2_coverage_union_agg
 List cpp_s2_coverage_union_agg(List geog, List s2options, bool naRm);
 RcppExport SEXP _s2_cpp_s2_coverage_union_agg(SEXP geogSEXP, SEXP s2optionsSEXP, SEXP naRmSEXP) {
@@ -1178,15 +1437,16 @@ BEGIN_RCPP
 END_RCPP
 }
 // cpp_s2_union_agg
-List cpp_s2_union_agg(List geog, List s2options, bool naRm);
-RcppExport SEXP _s2_cpp_s2_union_agg(SEXP geogSEXP, SEXP s2optionsSEXP, SEXP naRmSEXP) {
+List cpp_s2_union_agg(List geog, List s2options, bool naRm, int numThreads);
+RcppExport SEXP _s2_cpp_s2_union_agg(SEXP geogSEXP, SEXP s2optionsSEXP, SEXP naRmSEXP, SEXP numThreadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
     Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
     Rcpp::traits::input_parameter< bool >::type naRm(naRmSEXP);
-    rcpp_result_gen = Rcpp::wrap(cpp_s2_union_agg(geog, s2options, naRm));
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_union_agg(geog, s2options, naRm, numThreads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -1322,6 +1582,22 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_buffer
+List cpp_s2_buffer(List geog, NumericVector distance, NumericVector maxError, int endCapStyle, int polylineSide, int numThreads);
+RcppExport SEXP _s2_cpp_s2_buffer(SEXP geogSEXP, SEXP distanceSEXP, SEXP maxErrorSEXP, SEXP endCapStyleSEXP, SEXP polylineSideSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type maxError(maxErrorSEXP);
+    Rcpp::traits::input_parameter< int >::type endCapStyle(endCapStyleSEXP);
+    Rcpp::traits::input_parameter< int >::type polylineSide(polylineSideSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_buffer(geog, distance, maxError, endCapStyle, polylineSide, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cpp_s2_convex_hull
 List cpp_s2_convex_hull(List geog);
 RcppExport SEXP _s2_cpp_s2_convex_hull(SEXP geogSEXP) {
@@ -1345,6 +1621,54 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cpp_s2_agg_by
+List cpp_s2_agg_by(List geog, IntegerVector groupId, int nGroups, int aggType, List s2options, bool naRm, int numThreads);
+RcppExport SEXP _s2_cpp_s2_agg_by(SEXP geogSEXP, SEXP groupIdSEXP, SEXP nGroupsSEXP, SEXP aggTypeSEXP, SEXP s2optionsSEXP, SEXP naRmSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type groupId(groupIdSEXP);
+    Rcpp::traits::input_parameter< int >::type nGroups(nGroupsSEXP);
+    Rcpp::traits::input_parameter< int >::type aggType(aggTypeSEXP);
+    Rcpp::traits::input_parameter< List >::type s2options(s2optionsSEXP);
+    Rcpp::traits::input_parameter< bool >::type naRm(naRmSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_agg_by(geog, groupId, nGroups, aggType, s2options, naRm, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_geog_from_wkb
+List cpp_s2_geog_from_wkb(List wkb, bool oriented, bool check, bool lax, SEXP projectionXPtr, double tessellateTolerance, int numThreads);
+RcppExport SEXP _s2_cpp_s2_geog_from_wkb(SEXP wkbSEXP, SEXP orientedSEXP, SEXP checkSEXP, SEXP laxSEXP, SEXP projectionXPtrSEXP, SEXP tessellateToleranceSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type wkb(wkbSEXP);
+    Rcpp::traits::input_parameter< bool >::type oriented(orientedSEXP);
+    Rcpp::traits::input_parameter< bool >::type check(checkSEXP);
+    Rcpp::traits::input_parameter< bool >::type lax(laxSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type projectionXPtr(projectionXPtrSEXP);
+    Rcpp::traits::input_parameter< double >::type tessellateTolerance(tessellateToleranceSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_geog_from_wkb(wkb, oriented, check, lax, projectionXPtr, tessellateTolerance, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cpp_s2_as_binary
+List cpp_s2_as_binary(List geog, SEXP projectionXPtr, int endian, int numThreads);
+RcppExport SEXP _s2_cpp_s2_as_binary(SEXP geogSEXP, SEXP projectionXPtrSEXP, SEXP endianSEXP, SEXP numThreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type geog(geogSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type projectionXPtr(projectionXPtrSEXP);
+    Rcpp::traits::input_parameter< int >::type endian(endianSEXP);
+    Rcpp::traits::input_parameter< int >::type numThreads(numThreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cpp_s2_as_binary(geog, projectionXPtr, endian, numThreads));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 RcppExport SEXP c_s2_geography_writer_new(SEXP, SEXP, SEXP, SEXP, SEXP);
 RcppExport SEXP c_s2_handle_geography(SEXP, SEXP);
@@ -1384,9 +1708,10 @@ static const R_CallMethodDef CallEntries[] = {
     {"_s2_cpp_s2_geography_from_cell_union", (DL_FUNC) &_s2_cpp_s2_geography_from_cell_union, 1},
     {"_s2_cpp_s2_covering_cell_ids", (DL_FUNC) &_s2_cpp_s2_covering_cell_ids, 6},
     {"_s2_cpp_s2_covering_cell_ids_agg", (DL_FUNC) &_s2_cpp_s2_covering_cell_ids_agg, 7},
+    {"_s2_cpp_s2_region_terms", (DL_FUNC) &_s2_cpp_s2_region_terms, 11},
     {"_s2_cpp_s2_cell_sentinel", (DL_FUNC) &_s2_cpp_s2_cell_sentinel, 0},
     {"_s2_cpp_s2_cell_from_string", (DL_FUNC) &_s2_cpp_s2_cell_from_string, 1},
-    {"_s2_cpp_s2_cell_from_lnglat", (DL_FUNC) &_s2_cpp_s2_cell_from_lnglat, 1},
+    {"_s2_cpp_s2_cell_from_lnglat", (DL_FUNC) &_s2_cpp_s2_cell_from_lnglat, 2},
     {"_s2_cpp_s2_cell_to_lnglat", (DL_FUNC) &_s2_cpp_s2_cell_to_lnglat, 1},
     {"_s2_cpp_s2_cell_to_cell_union", (DL_FUNC) &_s2_cpp_s2_cell_to_cell_union, 1},
     {"_s2_cpp_s2_cell_is_na", (DL_FUNC) &_s2_cpp_s2_cell_is_na, 1},
@@ -1419,41 +1744,58 @@ static const R_CallMethodDef CallEntries[] = {
     {"_s2_cpp_s2_cell_max_distance", (DL_FUNC) &_s2_cpp_s2_cell_max_distance, 2},
     {"_s2_cpp_s2_cell_common_ancestor_level", (DL_FUNC) &_s2_cpp_s2_cell_common_ancestor_level, 2},
     {"_s2_cpp_s2_cell_common_ancestor_level_agg", (DL_FUNC) &_s2_cpp_s2_cell_common_ancestor_level_agg, 1},
+    {"_s2_cpp_s2_cell_bin", (DL_FUNC) &_s2_cpp_s2_cell_bin, 4},
+    {"_s2_cpp_s2_geog_from_geoarrow", (DL_FUNC) &_s2_cpp_s2_geog_from_geoarrow, 7},
+    {"_s2_cpp_s2_as_geoarrow", (DL_FUNC) &_s2_cpp_s2_as_geoarrow, 6},
+    {"_s2_cpp_s2_geography_index", (DL_FUNC) &_s2_cpp_s2_geography_index, 2},
+    {"_s2_cpp_s2_geography_index_encode", (DL_FUNC) &_s2_cpp_s2_geography_index_encode, 1},
+    {"_s2_cpp_s2_geography_index_decode", (DL_FUNC) &_s2_cpp_s2_geography_index_decode, 2},
     {"_s2_s2_geography_full", (DL_FUNC) &_s2_s2_geography_full, 1},
     {"_s2_cpp_s2_geography_is_na", (DL_FUNC) &_s2_cpp_s2_geography_is_na, 1},
-    {"_s2_s2_lnglat_from_s2_point", (DL_FUNC) &_s2_s2_lnglat_from_s2_point, 1},
-    {"_s2_s2_point_from_s2_lnglat", (DL_FUNC) &_s2_s2_point_from_s2_lnglat, 1},
+    {"_s2_cpp_s2_prepare", (DL_FUNC) &_s2_cpp_s2_prepare, 2},
+    {"_s2_cpp_s2_prepare_covering", (DL_FUNC) &_s2_cpp_s2_prepare_covering, 4},
+    {"_s2_cpp_s2_join_pairs", (DL_FUNC) &_s2_cpp_s2_join_pairs, 6},
+    {"_s2_cpp_s2_relate_pairs", (DL_FUNC) &_s2_cpp_s2_relate_pairs, 5},
+    {"_s2_cpp_s2_knn_join", (DL_FUNC) &_s2_cpp_s2_knn_join, 5},
+    {"_s2_cpp_s2_point_in_polygon_join", (DL_FUNC) &_s2_cpp_s2_point_in_polygon_join, 4},
+    {"_s2_s2_lnglat_from_s2_point", (DL_FUNC) &_s2_s2_lnglat_from_s2_point, 2},
+    {"_s2_s2_point_from_s2_lnglat", (DL_FUNC) &_s2_s2_point_from_s2_lnglat, 2},
     {"_s2_cpp_s2_closest_feature", (DL_FUNC) &_s2_cpp_s2_closest_feature, 2},
     {"_s2_cpp_s2_farthest_feature", (DL_FUNC) &_s2_cpp_s2_farthest_feature, 2},
     {"_s2_cpp_s2_closest_edges", (DL_FUNC) &_s2_cpp_s2_closest_edges, 5},
-    {"_s2_cpp_s2_may_intersect_matrix", (DL_FUNC) &_s2_cpp_s2_may_intersect_matrix, 5},
-    {"_s2_cpp_s2_contains_matrix", (DL_FUNC) &_s2_cpp_s2_contains_matrix, 3},
-    {"_s2_cpp_s2_within_matrix", (DL_FUNC) &_s2_cpp_s2_within_matrix, 3},
-    {"_s2_cpp_s2_intersects_matrix", (DL_FUNC) &_s2_cpp_s2_intersects_matrix, 3},
-    {"_s2_cpp_s2_equals_matrix", (DL_FUNC) &_s2_cpp_s2_equals_matrix, 3},
-    {"_s2_cpp_s2_touches_matrix", (DL_FUNC) &_s2_cpp_s2_touches_matrix, 3},
-    {"_s2_cpp_s2_dwithin_matrix", (DL_FUNC) &_s2_cpp_s2_dwithin_matrix, 3},
-    {"_s2_cpp_s2_distance_matrix", (DL_FUNC) &_s2_cpp_s2_distance_matrix, 2},
-    {"_s2_cpp_s2_max_distance_matrix", (DL_FUNC) &_s2_cpp_s2_max_distance_matrix, 2},
+    {"_s2_cpp_s2_may_intersect_matrix", (DL_FUNC) &_s2_cpp_s2_may_intersect_matrix, 6},
+    {"_s2_cpp_s2_contains_matrix", (DL_FUNC) &_s2_cpp_s2_contains_matrix, 4},
+    {"_s2_cpp_s2_within_matrix", (DL_FUNC) &_s2_cpp_s2_within_matrix, 4},
+    {"_s2_cpp_s2_intersects_matrix", (DL_FUNC) &_s2_cpp_s2_intersects_matrix, 4},
+    {"_s2_cpp_s2_equals_matrix", (DL_FUNC) &_s2_cpp_s2_equals_matrix, 4},
+    {"_s2_cpp_s2_touches_matrix", (DL_FUNC) &_s2_cpp_s2_touches_matrix, 4},
+    {"_s2_cpp_s2_dwithin_matrix", (DL_FUNC) &_s2_cpp_s2_dwithin_matrix, 4},
+    {"_s2_cpp_s2_distance_matrix", (DL_FUNC) &_s2_cpp_s2_distance_matrix, 3},
+    {"_s2_cpp_s2_max_distance_matrix", (DL_FUNC) &_s2_cpp_s2_max_distance_matrix, 3},
     {"_s2_cpp_s2_contains_matrix_brute_force", (DL_FUNC) &_s2_cpp_s2_contains_matrix_brute_force, 3},
     {"_s2_cpp_s2_within_matrix_brute_force", (DL_FUNC) &_s2_cpp_s2_within_matrix_brute_force, 3},
     {"_s2_cpp_s2_intersects_matrix_brute_force", (DL_FUNC) &_s2_cpp_s2_intersects_matrix_brute_force, 3},
     {"_s2_cpp_s2_disjoint_matrix_brute_force", (DL_FUNC) &_s2_cpp_s2_disjoint_matrix_brute_force, 3},
     {"_s2_cpp_s2_equals_matrix_brute_force", (DL_FUNC) &_s2_cpp_s2_equals_matrix_brute_force, 3},
     {"_s2_cpp_s2_dwithin_matrix_brute_force", (DL_FUNC) &_s2_cpp_s2_dwithin_matrix_brute_force, 3},
+    {"_s2_cpp_s2_index_query_candidates", (DL_FUNC) &_s2_cpp_s2_index_query_candidates, 4},
     {"_s2_cpp_s2_intersects", (DL_FUNC) &_s2_cpp_s2_intersects, 3},
     {"_s2_cpp_s2_equals", (DL_FUNC) &_s2_cpp_s2_equals, 3},
     {"_s2_cpp_s2_contains", (DL_FUNC) &_s2_cpp_s2_contains, 3},
     {"_s2_cpp_s2_touches", (DL_FUNC) &_s2_cpp_s2_touches, 3},
+    {"_s2_cpp_s2_relate", (DL_FUNC) &_s2_cpp_s2_relate, 3},
     {"_s2_cpp_s2_dwithin", (DL_FUNC) &_s2_cpp_s2_dwithin, 3},
     {"_s2_cpp_s2_prepared_dwithin", (DL_FUNC) &_s2_cpp_s2_prepared_dwithin, 3},
     {"_s2_cpp_s2_intersects_box", (DL_FUNC) &_s2_cpp_s2_intersects_box, 7},
+    {"_s2_cpp_s2_geography_encode", (DL_FUNC) &_s2_cpp_s2_geography_encode, 2},
+    {"_s2_cpp_s2_geography_decode", (DL_FUNC) &_s2_cpp_s2_geography_decode, 2},
     {"_s2_cpp_s2_intersection", (DL_FUNC) &_s2_cpp_s2_intersection, 3},
     {"_s2_cpp_s2_union", (DL_FUNC) &_s2_cpp_s2_union, 3},
     {"_s2_cpp_s2_difference", (DL_FUNC) &_s2_cpp_s2_difference, 3},
     {"_s2_cpp_s2_sym_difference", (DL_FUNC) &_s2_cpp_s2_sym_difference, 3},
+    {"_s2_cpp_s2_max_memory_usage", (DL_FUNC) &_s2_cpp_s2_max_memory_usage, 0},
     {"_s2_cpp_s2_coverage_union_agg", (DL_FUNC) &_s2_cpp_s2_coverage_union_agg, 3},
-    {"_s2_cpp_s2_union_agg", (DL_FUNC) &_s2_cpp_s2_union_agg, 3},
+    {"_s2_cpp_s2_union_agg", (DL_FUNC) &_s2_cpp_s2_union_agg, 4},
     {"_s2_cpp_s2_centroid_agg", (DL_FUNC) &_s2_cpp_s2_centroid_agg, 2},
     {"_s2_cpp_s2_rebuild_agg", (DL_FUNC) &_s2_cpp_s2_rebuild_agg, 3},
     {"_s2_cpp_s2_closest_point", (DL_FUNC) &_s2_cpp_s2_closest_point, 2},
@@ -1465,8 +1807,12 @@ static const R_CallMethodDef CallEntries[] = {
     {"_s2_cpp_s2_unary_union", (DL_FUNC) &_s2_cpp_s2_unary_union, 2},
     {"_s2_cpp_s2_interpolate_normalized", (DL_FUNC) &_s2_cpp_s2_interpolate_normalized, 2},
     {"_s2_cpp_s2_buffer_cells", (DL_FUNC) &_s2_cpp_s2_buffer_cells, 4},
+    {"_s2_cpp_s2_buffer", (DL_FUNC) &_s2_cpp_s2_buffer, 6},
     {"_s2_cpp_s2_convex_hull", (DL_FUNC) &_s2_cpp_s2_convex_hull, 1},
     {"_s2_cpp_s2_convex_hull_agg", (DL_FUNC) &_s2_cpp_s2_convex_hull_agg, 2},
+    {"_s2_cpp_s2_agg_by", (DL_FUNC) &_s2_cpp_s2_agg_by, 7},
+    {"_s2_cpp_s2_geog_from_wkb", (DL_FUNC) &_s2_cpp_s2_geog_from_wkb, 7},
+    {"_s2_cpp_s2_as_binary", (DL_FUNC) &_s2_cpp_s2_as_binary, 4},
     {"c_s2_geography_writer_new",         (DL_FUNC) &c_s2_geography_writer_new,         5},
     {"c_s2_handle_geography",             (DL_FUNC) &c_s2_handle_geography,             2},
     {"c_s2_handle_geography_tessellated", (DL_FUNC) &c_s2_handle_geography_tessellated, 2},
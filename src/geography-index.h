@@ -0,0 +1,77 @@
+
+#ifndef GEOGRAPHY_INDEX_H
+#define GEOGRAPHY_INDEX_H
+
+#include <memory>
+
+#include <Rcpp.h>
+
+#include "geography.h"
+
+// An s2geography::GeographyIndex over the features of an s2_geography vector
+// that can be built once and used as the `y` argument of many calls to
+// the indexed matrix functions. On the R side this is a list() with class
+// "s2_geography_index" whose "geography" element is the indexed vector and
+// whose "index" element is an external pointer to an RGeographyIndex.
+class RGeographyIndex {
+public:
+  RGeographyIndex(int maxEdgesPerCell = 50) {
+    MutableS2ShapeIndex::Options index_options;
+    index_options.set_max_edges_per_cell(maxEdgesPerCell);
+    index_ = std::make_shared<s2geography::GeographyIndex>(index_options);
+  }
+
+  void Add(Rcpp::List geog) {
+    for (R_xlen_t j = 0; j < geog.size(); j++) {
+      Rcpp::checkUserInterrupt();
+      SEXP item = geog[j];
+
+      if (item == R_NilValue) {
+        Rcpp::stop("Missing `y` not allowed in binary indexed operators()");
+      } else {
+        Rcpp::XPtr<RGeography> feature(item);
+        index_->Add(feature->Geog(), j);
+      }
+    }
+  }
+
+  const std::shared_ptr<s2geography::GeographyIndex>& Index() const {
+    return index_;
+  }
+
+  std::shared_ptr<s2geography::GeographyIndex>& MutableIndex() {
+    return index_;
+  }
+
+  // Returns the vector of features that geog2 refers to, which is geog2 itself
+  // if it is not an s2_geography_index.
+  static Rcpp::List Geography(Rcpp::List geog2) {
+    if (IsIndex(geog2)) {
+      return geog2["geography"];
+    } else {
+      return geog2;
+    }
+  }
+
+  static bool IsIndex(SEXP geog2) {
+    return Rf_inherits(geog2, "s2_geography_index");
+  }
+
+  static RGeographyIndex* Get(Rcpp::List geog2) {
+    SEXP xptr = geog2["index"];
+    if (TYPEOF(xptr) != EXTPTRSXP || R_ExternalPtrAddr(xptr) == nullptr) {
+      Rcpp::stop(
+        "Invalid or unserialized s2_geography_index(): "
+        "use s2_geography_index_encode() and s2_geography_index_decode() "
+        "to save and restore an index"
+      );
+    }
+
+    return reinterpret_cast<RGeographyIndex*>(R_ExternalPtrAddr(xptr));
+  }
+
+private:
+  std::shared_ptr<s2geography::GeographyIndex> index_;
+};
+
+#endif
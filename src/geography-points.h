@@ -0,0 +1,469 @@
+
+#ifndef GEOGRAPHY_POINTS_H
+#define GEOGRAPHY_POINTS_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "s2/s1chord_angle.h"
+#include "s2/s2boolean_operation.h"
+#include "s2/s2closest_edge_query.h"
+#include "s2/s2contains_point_query.h"
+#include "s2/s2edge_distances.h"
+#include "s2/s2furthest_edge_query.h"
+#include "s2/s2projections.h"
+
+#include "geography.h"
+#include "geography-operator.h"
+
+// Most relations that involve a point feature can be computed without an
+// index on that feature: the distance between two points is the chord angle
+// between them and whether a point intersects a polygon is a single
+// S2ContainsPointQuery on the index of the polygon. Each method returns true
+// and sets *result if it was able to compute the relation this way; otherwise
+// it returns false and the caller should use the general version (which
+// builds an index on both features). The results are the same as those of
+// the corresponding S2BooleanOperation or edge query.
+class PointFastPath {
+public:
+  // A feature is an RGeography and/or a set of points. Rows of an
+  // s2_lnglat() or s2_point() vector (see PointVector) are points without
+  // an RGeography.
+  struct Feature {
+    Feature(RGeography* geog): geog(geog), points(Points(geog)) {}
+    Feature(const std::vector<S2Point>* points): geog(nullptr), points(points) {}
+
+    RGeography* geog;
+    const std::vector<S2Point>* points;
+  };
+
+  PointFastPath(): PointFastPath(S2BooleanOperation::Options()) {}
+
+  PointFastPath(const S2BooleanOperation::Options& options):
+    containsOptions(ContainsOptions(options)) {}
+
+  // Returns the S2ContainsPointQuery options whose vertex model matches the
+  // polygon model of options
+  static S2ContainsPointQueryOptions ContainsOptions(const S2BooleanOperation::Options& options) {
+    S2ContainsPointQueryOptions out;
+    switch (options.polygon_model()) {
+    case S2BooleanOperation::PolygonModel::OPEN:
+      out.set_vertex_model(S2VertexModel::OPEN);
+      break;
+    case S2BooleanOperation::PolygonModel::CLOSED:
+      out.set_vertex_model(S2VertexModel::CLOSED);
+      break;
+    default:
+      out.set_vertex_model(S2VertexModel::SEMI_OPEN);
+      break;
+    }
+
+    return out;
+  }
+
+  bool Intersects(const Feature& feature1, const Feature& feature2, bool* result) const {
+    const std::vector<S2Point>* points1 = feature1.points;
+    const std::vector<S2Point>* points2 = feature2.points;
+
+    if (points1 != nullptr && points2 != nullptr) {
+      *result = std::any_of(points1->begin(), points1->end(), [&](const S2Point& pt) {
+        return ContainsPoint(*points2, pt);
+      });
+      return true;
+    } else if (points1 != nullptr && IsPolygon(feature2)) {
+      *result = AnyContained(*points1, feature2);
+      return true;
+    } else if (points2 != nullptr && IsPolygon(feature1)) {
+      *result = AnyContained(*points2, feature1);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // Like s2geography::s2_contains(), an empty feature2 is never contained
+  bool Contains(const Feature& feature1, const Feature& feature2, bool* result) const {
+    const std::vector<S2Point>* points2 = feature2.points;
+    if (points2 == nullptr) {
+      return false;
+    }
+
+    const std::vector<S2Point>* points1 = feature1.points;
+    if (points1 != nullptr) {
+      *result = !points2->empty() &&
+        std::all_of(points2->begin(), points2->end(), [&](const S2Point& pt) {
+          return ContainsPoint(*points1, pt);
+        });
+      return true;
+    } else if (IsPolygon(feature1)) {
+      *result = !points2->empty() && AllContained(*points2, feature1);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool Equals(const Feature& feature1, const Feature& feature2, bool* result) const {
+    const std::vector<S2Point>* points1 = feature1.points;
+    const std::vector<S2Point>* points2 = feature2.points;
+    if (points1 == nullptr || points2 == nullptr) {
+      return false;
+    }
+
+    *result =
+      std::all_of(points1->begin(), points1->end(), [&](const S2Point& pt) {
+        return ContainsPoint(*points2, pt);
+      }) &&
+      std::all_of(points2->begin(), points2->end(), [&](const S2Point& pt) {
+        return ContainsPoint(*points1, pt);
+      });
+    return true;
+  }
+
+  // The minimum distance between point features is computed directly;
+  // the minimum distance between a point feature and any other feature uses
+  // an S2ClosestEdgeQuery::PointTarget for each point.
+  bool Distance(const Feature& feature1, const Feature& feature2, S1ChordAngle* result) const {
+    const std::vector<S2Point>* points1 = feature1.points;
+    const std::vector<S2Point>* points2 = feature2.points;
+
+    if (points1 != nullptr && points2 != nullptr) {
+      *result = MinDistance(*points1, *points2);
+      return true;
+    } else if (points1 != nullptr) {
+      S2ClosestEdgeQuery query(&feature2.geog->Index().ShapeIndex());
+      *result = MinDistance(&query, *points1);
+      return true;
+    } else if (points2 != nullptr) {
+      S2ClosestEdgeQuery query(&feature1.geog->Index().ShapeIndex());
+      *result = MinDistance(&query, *points2);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool MaxDistance(const Feature& feature1, const Feature& feature2,
+                   S1ChordAngle* result) const {
+    const std::vector<S2Point>* points1 = feature1.points;
+    const std::vector<S2Point>* points2 = feature2.points;
+
+    if (points1 != nullptr && points2 != nullptr) {
+      *result = MaxDistance(*points1, *points2);
+      return true;
+    } else if (points1 != nullptr) {
+      S2FurthestEdgeQuery query(&feature2.geog->Index().ShapeIndex());
+      *result = MaxDistance(&query, *points1);
+      return true;
+    } else if (points2 != nullptr) {
+      S2FurthestEdgeQuery query(&feature1.geog->Index().ShapeIndex());
+      *result = MaxDistance(&query, *points2);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  bool IsDistanceLessOrEqual(const Feature& feature1, const Feature& feature2,
+                             S1ChordAngle limit, bool* result) const {
+    const std::vector<S2Point>* points1 = feature1.points;
+    const std::vector<S2Point>* points2 = feature2.points;
+
+    if (points1 != nullptr && points2 != nullptr) {
+      *result = false;
+      for (const S2Point& pt2: *points2) {
+        for (const S2Point& pt1: *points1) {
+          if (S1ChordAngle(pt1, pt2) <= limit) {
+            *result = true;
+            return true;
+          }
+        }
+      }
+
+      return true;
+    } else if (points1 != nullptr || points2 != nullptr) {
+      RGeography* other = points1 != nullptr ? feature2.geog : feature1.geog;
+      const std::vector<S2Point>& points = points1 != nullptr ? *points1 : *points2;
+
+      S2ClosestEdgeQuery query(&other->Index().ShapeIndex());
+      *result = std::any_of(points.begin(), points.end(), [&](const S2Point& pt) {
+        S2ClosestEdgeQuery::PointTarget target(pt);
+        return query.IsDistanceLessOrEqual(&target, limit);
+      });
+
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // These give the same result as an edge query with a ShapeIndexTarget
+  // on the points (which computes the same chord angles)
+  static S1ChordAngle MinDistance(const std::vector<S2Point>& points1,
+                                  const std::vector<S2Point>& points2) {
+    S1ChordAngle distance = S1ChordAngle::Infinity();
+    for (const S2Point& pt2: points2) {
+      for (const S2Point& pt1: points1) {
+        distance = std::min(distance, S1ChordAngle(pt1, pt2));
+      }
+    }
+
+    return distance;
+  }
+
+  static S1ChordAngle MaxDistance(const std::vector<S2Point>& points1,
+                                  const std::vector<S2Point>& points2) {
+    S1ChordAngle distance = S1ChordAngle::Negative();
+    for (const S2Point& pt2: points2) {
+      for (const S2Point& pt1: points1) {
+        S2::UpdateMaxDistance(pt1, pt2, pt2, &distance);
+      }
+    }
+
+    return distance;
+  }
+
+  static S1ChordAngle MinDistance(S2ClosestEdgeQuery* query,
+                                  const std::vector<S2Point>& points) {
+    S1ChordAngle distance = S1ChordAngle::Infinity();
+    for (const S2Point& pt: points) {
+      S2ClosestEdgeQuery::PointTarget target(pt);
+      distance = std::min(distance, query->GetDistance(&target));
+    }
+
+    return distance;
+  }
+
+  static S1ChordAngle MaxDistance(S2FurthestEdgeQuery* query,
+                                  const std::vector<S2Point>& points) {
+    S1ChordAngle distance = S1ChordAngle::Negative();
+    for (const S2Point& pt: points) {
+      S2FurthestEdgeQuery::PointTarget target(pt);
+      distance = std::max(distance, query->GetDistance(&target));
+    }
+
+    return distance;
+  }
+
+  // Returns a PointTarget for a feature with exactly one point or a
+  // ShapeIndexTarget (which requires an index on feature) otherwise
+  template <class Query>
+  static std::unique_ptr<typename Query::Target> MakeTarget(RGeography* feature) {
+    const std::vector<S2Point>* points = Points(feature);
+    if (points != nullptr && points->size() == 1) {
+      return absl::make_unique<typename Query::PointTarget>(points->front());
+    } else {
+      return absl::make_unique<typename Query::ShapeIndexTarget>(
+        &feature->Index().ShapeIndex()
+      );
+    }
+  }
+
+  // Returns the points of a feature if it is a PointGeography or nullptr
+  // otherwise
+  static const std::vector<S2Point>* Points(RGeography* feature) {
+    auto point = dynamic_cast<const s2geography::PointGeography*>(&feature->Geog());
+    if (point == nullptr) {
+      return nullptr;
+    } else {
+      return &point->Points();
+    }
+  }
+
+  static bool IsPolygon(const Feature& feature) {
+    return feature.geog != nullptr &&
+      (dynamic_cast<const s2geography::PolygonGeography*>(&feature.geog->Geog()) != nullptr ||
+       dynamic_cast<const s2geography::LaxPolygonGeography*>(&feature.geog->Geog()) != nullptr);
+  }
+
+private:
+  S2ContainsPointQueryOptions containsOptions;
+
+  static bool ContainsPoint(const std::vector<S2Point>& points, const S2Point& pt) {
+    return std::find(points.begin(), points.end(), pt) != points.end();
+  }
+
+  bool AnyContained(const std::vector<S2Point>& points, const Feature& polygon) const {
+    auto query = MakeS2ContainsPointQuery(&polygon.geog->Index().ShapeIndex(), containsOptions);
+    return std::any_of(points.begin(), points.end(), [&](const S2Point& pt) {
+      return query.Contains(pt);
+    });
+  }
+
+  bool AllContained(const std::vector<S2Point>& points, const Feature& polygon) const {
+    auto query = MakeS2ContainsPointQuery(&polygon.geog->Index().ShapeIndex(), containsOptions);
+    return std::all_of(points.begin(), points.end(), [&](const S2Point& pt) {
+      return query.Contains(pt);
+    });
+  }
+};
+
+// The points of an s2_lnglat() vector (or any wk::xy()) or an s2_point()
+// vector (a wk::xyz() with s2_point_crs()), read directly from their numeric
+// columns. Points with a missing coordinate are empty.
+class PointVector {
+public:
+  PointVector(SEXP x): projection(180) {
+    SEXP crs = Rf_getAttrib(x, Rf_install("crs"));
+    this->isUnitVector = Rf_inherits(crs, "s2_point_crs");
+    this->size_ = Rf_xlength(VECTOR_ELT(x, 0));
+    this->xs = REAL(VECTOR_ELT(x, 0));
+    this->ys = REAL(VECTOR_ELT(x, 1));
+    this->zs = this->isUnitVector ? REAL(VECTOR_ELT(x, 2)) : nullptr;
+  }
+
+  static bool IsPointVector(SEXP x) {
+    return Rf_inherits(x, "wk_xy");
+  }
+
+  // The number of features in x, which may be a point vector or a list
+  static R_xlen_t Length(SEXP x) {
+    if (IsPointVector(x)) {
+      return Rf_xlength(VECTOR_ELT(x, 0));
+    } else {
+      return Rf_xlength(x);
+    }
+  }
+
+  R_xlen_t size() const {
+    return size_;
+  }
+
+  // Returns false if the point at i is empty. Longitudes and latitudes are
+  // converted using the same projection as s2_geography_writer().
+  bool Point(R_xlen_t i, S2Point* point) const {
+    if (this->isUnitVector) {
+      if (std::isnan(xs[i]) || std::isnan(ys[i]) || std::isnan(zs[i])) {
+        return false;
+      }
+
+      *point = S2Point(xs[i], ys[i], zs[i]).Normalize();
+    } else {
+      if (std::isnan(xs[i]) || std::isnan(ys[i])) {
+        return false;
+      }
+
+      *point = projection.Unproject(R2Point(xs[i], ys[i]));
+    }
+
+    return true;
+  }
+
+private:
+  S2::PlateCarreeProjection projection;
+  bool isUnitVector;
+  R_xlen_t size_;
+  const double* xs;
+  const double* ys;
+  const double* zs;
+};
+
+// Like BinaryGeographyOperator, except that geog1 and/or geog2 may also be
+// a PointVector whose rows are processed without creating an RGeography for
+// each point. Features from an s2_geography() are passed to processFeature()
+// along with their points (if they are a PointGeography).
+template<class VectorType, class ScalarType>
+class BinaryPointGeographyOperator {
+public:
+  VectorType processVector(Rcpp::List geog1, Rcpp::List geog2) {
+    std::unique_ptr<PointVector> points1;
+    std::unique_ptr<PointVector> points2;
+    if (PointVector::IsPointVector(geog1)) {
+      points1 = absl::make_unique<PointVector>(geog1);
+    }
+    if (PointVector::IsPointVector(geog2)) {
+      points2 = absl::make_unique<PointVector>(geog2);
+    }
+
+    R_xlen_t size1 = points1 ? points1->size() : geog1.size();
+    R_xlen_t size2 = points2 ? points2->size() : geog2.size();
+    if (size1 != size2) {
+      Rcpp::stop("Incompatible lengths");
+    }
+
+    VectorType output(size1);
+
+    Rcpp::IntegerVector problemId;
+    Rcpp::CharacterVector problems;
+
+    // scratch space for the points of a PointVector row
+    std::vector<S2Point> rowPoints1;
+    std::vector<S2Point> rowPoints2;
+
+    for (R_xlen_t i = 0; i < size1; i++) {
+      Rcpp::checkUserInterrupt();
+
+      RGeography* feature1 = nullptr;
+      RGeography* feature2 = nullptr;
+      if (!points1) {
+        SEXP item1 = geog1[i];
+        if (item1 != R_NilValue) {
+          feature1 = Rcpp::XPtr<RGeography>(item1).get();
+        }
+      }
+      if (!points2) {
+        SEXP item2 = geog2[i];
+        if (item2 != R_NilValue) {
+          feature2 = Rcpp::XPtr<RGeography>(item2).get();
+        }
+      }
+
+      if ((!points1 && feature1 == nullptr) || (!points2 && feature2 == nullptr)) {
+        output[i] = VectorType::get_na();
+        continue;
+      }
+
+      try {
+        output[i] = processFeature(
+          points1 ? rowFeature(*points1, i, &rowPoints1) : PointFastPath::Feature(feature1),
+          points2 ? rowFeature(*points2, i, &rowPoints2) : PointFastPath::Feature(feature2),
+          i
+        );
+      } catch (GeographyOperatorException& e) {
+        output[i] = VectorType::get_na();
+        problemId.push_back(i);
+        problems.push_back(e.what());
+      }
+    }
+
+    if (problemId.size() > 0) {
+      Rcpp::Environment s2NS = Rcpp::Environment::namespace_env("s2");
+      Rcpp::Function stopProblems = s2NS["stop_problems_process"];
+      stopProblems(problemId, problems);
+    }
+
+    return output;
+  }
+
+  virtual ScalarType processFeature(const PointFastPath::Feature& feature1,
+                                    const PointFastPath::Feature& feature2,
+                                    R_xlen_t i) = 0;
+
+protected:
+  // Returns the geography of feature, creating it in scratch if feature is a
+  // PointVector row. This is only needed for the (uncommon) relations
+  // that PointFastPath can't compute.
+  static RGeography* geography(const PointFastPath::Feature& feature,
+                               std::unique_ptr<RGeography>* scratch) {
+    if (feature.geog != nullptr) {
+      return feature.geog;
+    }
+
+    *scratch = RGeography::MakePoint(*feature.points);
+    return scratch->get();
+  }
+
+private:
+  static PointFastPath::Feature rowFeature(const PointVector& points, R_xlen_t i,
+                                           std::vector<S2Point>* rowPoints) {
+    rowPoints->resize(1);
+    if (!points.Point(i, &(*rowPoints)[0])) {
+      rowPoints->clear();
+    }
+
+    return PointFastPath::Feature(rowPoints);
+  }
+};
+
+#endif
@@ -2,8 +2,15 @@
 #ifndef GEOGRAPHY_H
 #define GEOGRAPHY_H
 
+#include <mutex>
+#include <vector>
+
 #include <Rcpp.h>
 
+#include "s2/s2cap.h"
+#include "s2/s2region_coverer.h"
+#include "s2/s2shape_index_buffered_region.h"
+
 #include "s2geography.h"
 #include "s2-altrep.h"
 
@@ -16,14 +23,70 @@ public:
     return *geog_;
   }
 
+  // The index is built the first time it is requested. This is safe to call
+  // from more than one thread at once (e.g., from an s2_parallel_for() worker):
+  // the first caller builds the index and any others wait for it.
   const s2geography::ShapeIndexGeography& Index() {
-    if (!index_) {
+    std::call_once(index_once_, [this] {
       this->index_ = absl::make_unique<s2geography::ShapeIndexGeography>(*geog_);
-    }
+    });
 
     return *index_;
   }
 
+  // Builds the index and applies any pending updates such that subsequent
+  // queries do not pay the cost of building it.
+  void Prepare() {
+    Index().ShapeIndex().ForceBuild();
+  }
+
+  // Sets covering to the covering of the geography (or of the region within
+  // distance of it if distance is positive) computed by coverer. Coverings are
+  // cached by coverer options and distance such that joining the same features
+  // against more than one vector only computes them once. Like Index(), this
+  // is safe to call from more than one thread at once; however, each thread
+  // must use its own coverer.
+  void GetCovering(S2RegionCoverer* coverer, S1ChordAngle distance,
+                   std::vector<S2CellId>* covering) {
+    CoveringKey key{coverer->options(), distance};
+    {
+      std::lock_guard<std::mutex> lock(coverings_mutex_);
+      for (const auto& item: coverings_) {
+        if (item.first == key) {
+          *covering = item.second;
+          return;
+        }
+      }
+    }
+
+    if (distance <= S1ChordAngle::Zero()) {
+      coverer->GetCovering(*geog_->Region(), covering);
+    } else {
+      // a single point doesn't need an index to be buffered
+      auto point = dynamic_cast<const s2geography::PointGeography*>(geog_.get());
+      if (point != nullptr && point->Points().size() == 1) {
+        coverer->GetCovering(S2Cap(point->Points().front(), distance), covering);
+      } else {
+        S2ShapeIndexBufferedRegion buffered(&Index().ShapeIndex(), distance);
+        coverer->GetCovering(buffered, covering);
+      }
+    }
+
+    // the same covering may have been added by another thread in the meantime
+    std::lock_guard<std::mutex> lock(coverings_mutex_);
+    for (const auto& item: coverings_) {
+      if (item.first == key) {
+        return;
+      }
+    }
+
+    if (coverings_.size() >= kMaxCachedCoverings) {
+      coverings_.erase(coverings_.begin());
+    }
+
+    coverings_.emplace_back(key, *covering);
+  }
+
   // For an unknown reason, returning a SEXP from MakeXPtr results in
   // rchk reporting a memory protection error. Until this is sorted, return a
   // Rcpp::XPtr<>() (even though this might be slower)
@@ -76,8 +139,33 @@ public:
   }
 
 private:
+  struct CoveringKey {
+    int min_level;
+    int max_level;
+    int level_mod;
+    int max_cells;
+    S1ChordAngle distance;
+
+    CoveringKey(const S2RegionCoverer::Options& options, S1ChordAngle distance):
+      min_level(options.min_level()), max_level(options.max_level()),
+      level_mod(options.level_mod()), max_cells(options.max_cells()),
+      distance(distance) {}
+
+    bool operator==(const CoveringKey& other) const {
+      return min_level == other.min_level && max_level == other.max_level &&
+        level_mod == other.level_mod && max_cells == other.max_cells &&
+        distance == other.distance;
+    }
+  };
+
+  // the oldest covering is dropped when another one is added
+  static constexpr size_t kMaxCachedCoverings = 4;
+
   std::unique_ptr<s2geography::Geography> geog_;
   std::unique_ptr<s2geography::ShapeIndexGeography> index_;
+  std::once_flag index_once_;
+  std::vector<std::pair<CoveringKey, std::vector<S2CellId>>> coverings_;
+  std::mutex coverings_mutex_;
 
   static void finalize_xptr(SEXP xptr) {
     RGeography* geog = reinterpret_cast<RGeography*>(R_ExternalPtrAddr(xptr));
@@ -1,5 +1,6 @@
 
 #include "geography-operator.h"
+#include "geography-points.h"
 #include <Rcpp.h>
 using namespace Rcpp;
 
@@ -167,12 +168,20 @@ NumericVector cpp_s2_project_normalized(List geog1, List geog2) {
 
 // [[Rcpp::export]]
 NumericVector cpp_s2_distance(List geog1, List geog2) {
-  class Op: public BinaryGeographyOperator<NumericVector, double> {
+  class Op: public BinaryPointGeographyOperator<NumericVector, double> {
+    PointFastPath points;
 
-    double processFeature(XPtr<RGeography> feature1,
-                          XPtr<RGeography> feature2,
+    double processFeature(const PointFastPath::Feature& feature1,
+                          const PointFastPath::Feature& feature2,
                           R_xlen_t i) {
-      double distance = s2geography::s2_distance(feature1->Index(), feature2->Index());
+      double distance;
+      S1ChordAngle angle;
+      if (this->points.Distance(feature1, feature2, &angle)) {
+        distance = angle.ToAngle().radians();
+      } else {
+        // neither feature is a point, so both have a geography
+        distance = s2geography::s2_distance(feature1.geog->Index(), feature2.geog->Index());
+      }
 
       if (distance == R_PosInf) {
         return NA_REAL;
@@ -188,12 +197,20 @@ NumericVector cpp_s2_distance(List geog1, List geog2) {
 
 // [[Rcpp::export]]
 NumericVector cpp_s2_max_distance(List geog1, List geog2) {
-  class Op: public BinaryGeographyOperator<NumericVector, double> {
+  class Op: public BinaryPointGeographyOperator<NumericVector, double> {
+    PointFastPath points;
 
-    double processFeature(XPtr<RGeography> feature1,
-                          XPtr<RGeography> feature2,
+    double processFeature(const PointFastPath::Feature& feature1,
+                          const PointFastPath::Feature& feature2,
                           R_xlen_t i) {
-      double distance = s2geography::s2_max_distance(feature1->Index(), feature2->Index());
+      double distance;
+      S1ChordAngle angle;
+      if (this->points.MaxDistance(feature1, feature2, &angle)) {
+        distance = angle.ToAngle().radians();
+      } else {
+        // neither feature is a point, so both have a geography
+        distance = s2geography::s2_max_distance(feature1.geog->Index(), feature2.geog->Index());
+      }
 
       // returns -1 if one of the indexes is empty
       // NA is more consistent with the BigQuery
@@ -4,10 +4,12 @@
 #include "s2/s2latlng.h"
 #include "s2/s2cell_union.h"
 #include "s2/s2region_coverer.h"
+#include "s2/s2region_term_indexer.h"
 #include "s2/s2shape_index_buffered_region.h"
 #include "s2/s2region_union.h"
 
 #include "geography-operator.h"
+#include "s2-parallel.h"
 
 #include <Rcpp.h>
 using namespace Rcpp;
@@ -391,3 +393,116 @@ List cpp_s2_covering_cell_ids_agg(List geog, int min_level, int max_level,
   out.attr("class") = CharacterVector::create("s2_cell_union", "wk_vctr");
   return out;
 }
+
+// Index or query terms are generated for each feature independently using one
+// S2RegionTermIndexer per thread (the indexer keeps a coverer whose state
+// changes with every covering). Single points use the point versions of
+// GetIndexTerms()/GetQueryTerms(), which generate fewer terms than covering
+// the point as a region. The terms for all features are returned together as
+// (feature, term) pairs.
+// [[Rcpp::export]]
+List cpp_s2_region_terms(List geog, bool query, CharacterVector prefix,
+                         int min_level, int max_level, int max_cells, int level_mod,
+                         bool points_only, bool optimize_for_space,
+                         std::string marker, int numThreads) {
+  S2RegionTermIndexer::Options options;
+  options.set_min_level(min_level);
+  options.set_max_level(max_level);
+  options.set_max_cells(max_cells);
+  options.set_level_mod(level_mod);
+  options.set_index_contains_points_only(points_only);
+  options.set_optimize_for_space(optimize_for_space);
+  options.set_marker_character(marker[0]);
+
+  R_xlen_t n = geog.size();
+  std::vector<RGeography*> features(n, nullptr);
+  std::vector<std::string> prefixes(n);
+  for (R_xlen_t i = 0; i < n; i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue && !CharacterVector::is_na(prefix[i])) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features[i] = feature.get();
+      prefixes[i] = as<std::string>(prefix[i]);
+    }
+  }
+
+  std::vector<std::unique_ptr<S2RegionTermIndexer>> indexers;
+  for (int i = 0; i < std::max(numThreads, 1); i++) {
+    indexers.push_back(absl::make_unique<S2RegionTermIndexer>(options));
+  }
+
+  std::vector<std::vector<std::string>> terms(n);
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        S2RegionTermIndexer& indexer = *indexers[worker_id];
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] == nullptr) {
+            continue;
+          }
+
+          const s2geography::Geography& feature = features[i]->Geog();
+          auto points = dynamic_cast<const s2geography::PointGeography*>(&feature);
+          if (points != nullptr && points->Points().size() == 1) {
+            const S2Point& point = points->Points()[0];
+            if (query) {
+              terms[i] = indexer.GetQueryTerms(point, prefixes[i]);
+            } else {
+              terms[i] = indexer.GetIndexTerms(point, prefixes[i]);
+            }
+          } else if (!query && points_only) {
+            // the indexer can't index a region when the index contains
+            // only points, so each point gets its own terms
+            if (s2geography::s2_dimension(feature) > 0) {
+              throw s2geography::Exception(
+                "Can't generate index terms for a feature that is not a point "
+                "when points_only = TRUE [i = " + std::to_string(i + 1) + "]"
+              );
+            }
+
+            for (int j = 0; j < feature.num_shapes(); j++) {
+              std::unique_ptr<S2Shape> shape = feature.Shape(j);
+              for (int k = 0; k < shape->num_edges(); k++) {
+                std::vector<std::string> pointTerms =
+                  indexer.GetIndexTerms(shape->edge(k).v0, prefixes[i]);
+                terms[i].insert(terms[i].end(), pointTerms.begin(), pointTerms.end());
+              }
+            }
+
+            // nearby points share terms
+            std::sort(terms[i].begin(), terms[i].end());
+            terms[i].erase(std::unique(terms[i].begin(), terms[i].end()), terms[i].end());
+          } else {
+            std::unique_ptr<S2Region> region = feature.Region();
+            if (query) {
+              terms[i] = indexer.GetQueryTerms(*region, prefixes[i]);
+            } else {
+              terms[i] = indexer.GetIndexTerms(*region, prefixes[i]);
+            }
+          }
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  R_xlen_t size = 0;
+  for (const auto& featureTerms : terms) {
+    size += featureTerms.size();
+  }
+
+  IntegerVector featureId(size);
+  CharacterVector term(size);
+  R_xlen_t k = 0;
+  for (R_xlen_t i = 0; i < n; i++) {
+    for (const auto& featureTerm : terms[i]) {
+      featureId[k] = i + 1;
+      term[k] = featureTerm;
+      k++;
+    }
+  }
+
+  return List::create(_["feature"] = featureId, _["term"] = term);
+}
@@ -4,12 +4,15 @@
 #include <sstream>
 #include <algorithm>
 #include <set>
+#include <unordered_map>
 
 #include "s2/s2cell_id.h"
 #include "s2/s2cell.h"
 #include "s2/s2latlng.h"
 
 #include "geography.h"
+#include "s2-convert.h"
+#include "s2-parallel.h"
 
 #include <Rcpp.h>
 using namespace Rcpp;
@@ -141,26 +144,23 @@ NumericVector cpp_s2_cell_from_string(CharacterVector cellString) {
 }
 
 // [[Rcpp::export]]
-NumericVector cpp_s2_cell_from_lnglat(List lnglat) {
+NumericVector cpp_s2_cell_from_lnglat(List lnglat, int numThreads) {
     NumericVector lng = lnglat[0];
     NumericVector lat = lnglat[1];
     R_xlen_t size = lng.size();
     NumericVector cellId(size);
-    double* ptrDouble = REAL(cellId);
-    uint64_t* ptrCellId = (uint64_t*) ptrDouble;
 
-    for (R_xlen_t i = 0; i < size; i++) {
-      if ((i % 1000) == 0) {
-        Rcpp::checkUserInterrupt();
-      }
+    const double* ptrLng = REAL(lng);
+    const double* ptrLat = REAL(lat);
+    double* ptrDouble = REAL(cellId);
 
-      if (R_IsNA(lng[i]) || R_IsNA(lat[i])) {
-          ptrDouble[i] = NA_REAL;
-      } else {
-          S2LatLng ll = S2LatLng::FromDegrees(lat[i], lng[i]).Normalized();
-          ptrCellId[i] = S2CellId(ll).id();
-      }
-    }
+    s2_parallel_for(
+      size, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        s2_cell_from_lnglat_batch(ptrLng, ptrLat, ptrDouble, begin, end);
+      },
+      4096
+    );
 
     cellId.attr("class") = CharacterVector::create("s2_cell", "wk_vctr");
     return cellId;
@@ -807,3 +807,144 @@ int cpp_s2_cell_common_ancestor_level_agg(NumericVector cellId) {
 
   return cellIdCommon.level();
 }
+
+// Bins points into cells at one or more levels in a single pass over the
+// input. Each thread accumulates the count and sum of weights for each cell
+// in its own hash table (one per level) such that memory is proportional to
+// the number of occupied cells rather than the number of points; the tables
+// are merged and sorted by cell on the main thread. Longitudes and latitudes
+// are converted to cells in the same way as cpp_s2_cell_from_lnglat().
+// [[Rcpp::export]]
+List cpp_s2_cell_bin(SEXP x, IntegerVector levels, SEXP weight, int numThreads) {
+  struct Bin {
+    double count;
+    double sum;
+  };
+
+  using BinTable = std::unordered_map<uint64_t, Bin>;
+
+  const double* weights = weight == R_NilValue ? nullptr : REAL(weight);
+
+  // either a point vector (lng/lat or unit vector columns) or a list of
+  // features whose points are read on the main thread
+  bool isPointVector = Rf_inherits(x, "wk_xy");
+  bool isUnitVector = false;
+  const double* xs = nullptr;
+  const double* ys = nullptr;
+  const double* zs = nullptr;
+  std::vector<const std::vector<S2Point>*> points;
+  R_xlen_t n;
+
+  if (isPointVector) {
+    SEXP crs = Rf_getAttrib(x, Rf_install("crs"));
+    isUnitVector = Rf_inherits(crs, "s2_point_crs");
+    n = Rf_xlength(VECTOR_ELT(x, 0));
+    xs = REAL(VECTOR_ELT(x, 0));
+    ys = REAL(VECTOR_ELT(x, 1));
+    zs = isUnitVector ? REAL(VECTOR_ELT(x, 2)) : nullptr;
+  } else {
+    List geog(x);
+    n = geog.size();
+    points.resize(n, nullptr);
+    for (R_xlen_t i = 0; i < n; i++) {
+      SEXP item = geog[i];
+      if (item == R_NilValue) {
+        continue;
+      }
+
+      Rcpp::XPtr<RGeography> feature(item);
+      auto pointGeog = dynamic_cast<const s2geography::PointGeography*>(&feature->Geog());
+      if (pointGeog == nullptr) {
+        stop("Can't bin non-point geography [i = %d]", (int) i + 1);
+      }
+
+      points[i] = &pointGeog->Points();
+    }
+  }
+
+  int numTables = std::max(numThreads, 1);
+  std::vector<std::vector<BinTable>> tables(numTables, std::vector<BinTable>(levels.size()));
+  std::vector<int> levelValues(levels.begin(), levels.end());
+
+  s2_parallel_for(
+    n, numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      std::vector<BinTable>& workerTables = tables[worker_id];
+
+      auto add = [&](const S2CellId& leaf, double w) {
+        for (size_t k = 0; k < levelValues.size(); k++) {
+          Bin& bin = workerTables[k][leaf.parent(levelValues[k]).id()];
+          bin.count += 1;
+          bin.sum += w;
+        }
+      };
+
+      for (R_xlen_t i = begin; i < end; i++) {
+        double w = weights == nullptr ? 1 : weights[i];
+
+        if (!isPointVector) {
+          if (points[i] != nullptr) {
+            for (const S2Point& point: *points[i]) {
+              add(S2CellId(point), w);
+            }
+          }
+        } else if (isUnitVector) {
+          if (!std::isnan(xs[i]) && !std::isnan(ys[i]) && !std::isnan(zs[i])) {
+            add(S2CellId(S2Point(xs[i], ys[i], zs[i]).Normalize()), w);
+          }
+        } else if (!std::isnan(xs[i]) && !std::isnan(ys[i])) {
+          add(S2CellId(S2LatLng::FromDegrees(ys[i], xs[i]).Normalized()), w);
+        }
+      }
+    },
+    4096
+  );
+
+  // merge into the tables of the first worker
+  std::vector<BinTable>& merged = tables[0];
+  for (int t = 1; t < numTables; t++) {
+    for (size_t k = 0; k < levelValues.size(); k++) {
+      for (const auto& item: tables[t][k]) {
+        Bin& bin = merged[k][item.first];
+        bin.count += item.second.count;
+        bin.sum += item.second.sum;
+      }
+
+      BinTable().swap(tables[t][k]);
+    }
+  }
+
+  R_xlen_t size = 0;
+  for (const BinTable& table: merged) {
+    size += table.size();
+  }
+
+  IntegerVector level(size);
+  NumericVector cellId(size);
+  NumericVector count(size);
+  NumericVector sum(size);
+  uint64_t* ptrCellId = (uint64_t*) REAL(cellId);
+
+  R_xlen_t offset = 0;
+  std::vector<uint64_t> ids;
+  for (size_t k = 0; k < levelValues.size(); k++) {
+    ids.clear();
+    ids.reserve(merged[k].size());
+    for (const auto& item: merged[k]) {
+      ids.push_back(item.first);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    for (uint64_t id: ids) {
+      const Bin& bin = merged[k][id];
+      level[offset] = levelValues[k];
+      ptrCellId[offset] = id;
+      count[offset] = bin.count;
+      sum[offset] = bin.sum;
+      offset++;
+    }
+  }
+
+  cellId.attr("class") = CharacterVector::create("s2_cell", "wk_vctr");
+  return List::create(_["level"] = level, _["cell"] = cellId, _["count"] = count, _["sum"] = sum);
+}
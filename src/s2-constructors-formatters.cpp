@@ -534,8 +534,10 @@ int handle_points(const s2geography::PointGeography& geog,
   return WK_CONTINUE;
 }
 
-template <typename EdgeExporterT>
-int handle_polylines(const s2geography::PolylineGeography& geog,
+// Handles a PolylineGeography or a LaxPolylineGeography (whose polylines
+// have the same num_vertices() and vertex() accessors)
+template <typename EdgeExporterT, typename PolylineGeographyT>
+int handle_polylines(const PolylineGeographyT& geog,
                      EdgeExporterT* exporter,
                      wk_handler_t* handler,
                      uint32_t part_id = WK_PART_ID_NONE) {
@@ -555,7 +557,7 @@ int handle_polylines(const s2geography::PolylineGeography& geog,
     HANDLE_OR_RETURN(handler->geometry_start(&meta_child, part_id, handler->handler_data));
     HANDLE_OR_RETURN(handler->geometry_end(&meta_child, part_id, handler->handler_data));
   } else if (meta.size == 1) {
-    const S2Polyline& poly = *geog.Polylines()[0];
+    const auto& poly = *geog.Polylines()[0];
     meta_child.size = poly.num_vertices();
     HANDLE_OR_RETURN(handler->geometry_start(&meta_child, part_id, handler->handler_data));
 
@@ -573,7 +575,7 @@ int handle_polylines(const s2geography::PolylineGeography& geog,
     HANDLE_OR_RETURN(handler->geometry_start(&meta, part_id, handler->handler_data));
 
     for (size_t i = 0; i < geog.Polylines().size(); i++) {
-      const S2Polyline& poly = *geog.Polylines()[i];
+      const auto& poly = *geog.Polylines()[i];
       meta_child.size = poly.num_vertices();
       HANDLE_OR_RETURN(handler->geometry_start(&meta_child, i, handler->handler_data));
 
@@ -727,6 +729,87 @@ int handle_polygon(const s2geography::PolygonGeography& geog,
   return WK_CONTINUE;
 }
 
+// Lax loops already have their interior on the left (i.e., shells are
+// counter-clockwise and holes are clockwise), so all loops are written in order
+template <typename EdgeExporterT>
+int handle_lax_loop(const S2LaxPolygonShape& polygon, int i,
+                    EdgeExporterT* exporter,
+                    const wk_meta_t* meta, uint32_t loop_id, wk_handler_t* handler) {
+  int result;
+  int n = polygon.num_loop_vertices(i);
+
+  if (n == 0) {
+    return handler->error("Unexpected S2LaxPolygonShape loop with 0 vertices", handler->handler_data);
+  }
+
+  HANDLE_OR_RETURN(handler->ring_start(meta, n + 1, loop_id, handler->handler_data));
+
+  exporter->reset();
+  for (int j = 0; j < n; j++) {
+    HANDLE_OR_RETURN(exporter->coord_in_series(meta, polygon.loop_vertex(i, j), handler));
+  }
+  HANDLE_OR_RETURN(exporter->last_coord_in_loop(meta, polygon.loop_vertex(i, 0), handler));
+
+  HANDLE_OR_RETURN(handler->ring_end(meta, n + 1, loop_id, handler->handler_data));
+  return WK_CONTINUE;
+}
+
+template <typename EdgeExporterT>
+int handle_lax_shell(const S2LaxPolygonShape& polygon, int loop_begin, int loop_end,
+                     EdgeExporterT* exporter,
+                     const wk_meta_t* meta, wk_handler_t* handler) {
+  int result;
+  for (int i = loop_begin; i < loop_end; i++) {
+    HANDLE_OR_RETURN(handle_lax_loop<EdgeExporterT>(polygon, i, exporter, meta, i - loop_begin, handler));
+  }
+
+  return WK_CONTINUE;
+}
+
+template <typename EdgeExporterT>
+int handle_polygon(const s2geography::LaxPolygonGeography& geog,
+                   EdgeExporterT* exporter,
+                   wk_handler_t* handler,
+                   uint32_t part_id = WK_PART_ID_NONE) {
+  const S2LaxPolygonShape& poly = *geog.Polygon();
+  const std::vector<int>& offsets = geog.LoopOffsets();
+
+  int result;
+
+  wk_meta_t meta;
+  WK_META_RESET(meta, WK_MULTIPOLYGON);
+  meta.size = geog.num_polygons();
+  exporter->set_meta_flags(&meta);
+
+  wk_meta_t meta_child;
+  WK_META_RESET(meta_child, WK_POLYGON);
+  exporter->set_meta_flags(&meta_child);
+
+  if (meta.size == 0) {
+    meta_child.size = 0;
+    HANDLE_OR_RETURN(handler->geometry_start(&meta_child, part_id, handler->handler_data));
+    HANDLE_OR_RETURN(handler->geometry_end(&meta_child, part_id, handler->handler_data));
+  } else if (meta.size == 1) {
+    meta_child.size = offsets[1] - offsets[0];
+    HANDLE_OR_RETURN(handler->geometry_start(&meta_child, part_id, handler->handler_data));
+    HANDLE_OR_RETURN(handle_lax_shell<EdgeExporterT>(poly, offsets[0], offsets[1], exporter, &meta_child, handler));
+    HANDLE_OR_RETURN(handler->geometry_end(&meta_child, part_id, handler->handler_data));
+  } else {
+    HANDLE_OR_RETURN(handler->geometry_start(&meta, part_id, handler->handler_data));
+
+    for (int i = 0; i < geog.num_polygons(); i++) {
+      meta_child.size = offsets[i + 1] - offsets[i];
+      HANDLE_OR_RETURN(handler->geometry_start(&meta_child, i, handler->handler_data));
+      HANDLE_OR_RETURN(handle_lax_shell<EdgeExporterT>(poly, offsets[i], offsets[i + 1], exporter, &meta_child, handler));
+      HANDLE_OR_RETURN(handler->geometry_end(&meta_child, i, handler->handler_data));
+    }
+
+    HANDLE_OR_RETURN(handler->geometry_end(&meta, part_id, handler->handler_data));
+  }
+
+  return WK_CONTINUE;
+}
+
 template <typename EdgeExporterT>
 int handle_collection(const s2geography::GeographyCollection& geog,
                       EdgeExporterT* exporter,
@@ -761,6 +844,18 @@ int handle_collection(const s2geography::GeographyCollection& geog,
       continue;
     }
 
+    auto child_lax_polyline = dynamic_cast<const s2geography::LaxPolylineGeography*>(child_ptr);
+    if (child_lax_polyline != nullptr) {
+      HANDLE_OR_RETURN(handle_polylines<EdgeExporterT>(*child_lax_polyline, exporter, handler, i));
+      continue;
+    }
+
+    auto child_lax_polygon = dynamic_cast<const s2geography::LaxPolygonGeography*>(child_ptr);
+    if (child_lax_polygon != nullptr) {
+      HANDLE_OR_RETURN(handle_polygon<EdgeExporterT>(*child_lax_polygon, exporter, handler, i));
+      continue;
+    }
+
     auto child_collection = dynamic_cast<const s2geography::GeographyCollection*>(child_ptr);
     if (child_collection != nullptr) {
       HANDLE_OR_RETURN(handle_collection<EdgeExporterT>(*child_collection, exporter, handler, i));
@@ -816,8 +911,14 @@ SEXP handle_geography_templ(SEXP data, EdgeExporterT* exporter, wk_handler_t* ha
                 HANDLE_CONTINUE_OR_BREAK(handle_polygon<EdgeExporterT>(*child_polygon, exporter, handler));
               } else {
                 auto child_collection = dynamic_cast<const s2geography::GeographyCollection*>(geog_ptr);
+                auto child_lax_polyline = dynamic_cast<const s2geography::LaxPolylineGeography*>(geog_ptr);
+                auto child_lax_polygon = dynamic_cast<const s2geography::LaxPolygonGeography*>(geog_ptr);
                 if (child_collection != nullptr) {
                   HANDLE_CONTINUE_OR_BREAK(handle_collection<EdgeExporterT>(*child_collection, exporter, handler));
+                } else if (child_lax_polyline != nullptr) {
+                  HANDLE_CONTINUE_OR_BREAK(handle_polylines<EdgeExporterT>(*child_lax_polyline, exporter, handler));
+                } else if (child_lax_polygon != nullptr) {
+                  HANDLE_CONTINUE_OR_BREAK(handle_polygon<EdgeExporterT>(*child_lax_polygon, exporter, handler));
                 } else {
                   HANDLE_CONTINUE_OR_BREAK(
                     handler->error("Unsupported S2Geography subclass", handler->handler_data));
@@ -0,0 +1,75 @@
+#ifndef S2_CONVERT_H
+#define S2_CONVERT_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "s2/s2cell_id.h"
+#include "s2/s2latlng.h"
+#include "s2/s2point.h"
+
+#include <Rcpp.h>
+
+// Batch conversions between longitude/latitude (in degrees), unit vectors,
+// and cell identifiers for contiguous ranges of double arrays (e.g., the
+// columns of an s2_lnglat() or s2_point() vector). Each element is computed
+// using exactly the same S2 calls as the corresponding scalar conversion
+// (S2LatLng::FromDegrees(lat, lng).Normalized().ToPoint(),
+// S2LatLng(S2Point), and S2CellId(S2LatLng)) such that results are
+// bit-identical; the gain comes from reading and writing raw arrays instead
+// of Rcpp element proxies and from splitting the range across threads
+// using s2_parallel_for(). These functions only use the R API to read
+// NA_REAL and to check for NA using R_IsNA() (which only inspects the bits of
+// its argument), so they are safe to call from a worker thread. Like the
+// scalar conversions, elements with a nan coordinate (or an NA coordinate for
+// cells) are converted to NA_REAL.
+
+static inline void s2_point_from_lnglat_batch(const double* lng, const double* lat,
+                                              double* x, double* y, double* z,
+                                              R_xlen_t begin, R_xlen_t end) {
+  for (R_xlen_t i = begin; i < end; i++) {
+    if (std::isnan(lng[i]) || std::isnan(lat[i])) {
+      x[i] = NA_REAL;
+      y[i] = NA_REAL;
+      z[i] = NA_REAL;
+    } else {
+      S2Point point = S2LatLng::FromDegrees(lat[i], lng[i]).Normalized().ToPoint();
+      x[i] = point.x();
+      y[i] = point.y();
+      z[i] = point.z();
+    }
+  }
+}
+
+static inline void s2_lnglat_from_point_batch(const double* x, const double* y,
+                                              const double* z, double* lng,
+                                              double* lat, R_xlen_t begin,
+                                              R_xlen_t end) {
+  for (R_xlen_t i = begin; i < end; i++) {
+    if (std::isnan(x[i]) || std::isnan(y[i]) || std::isnan(z[i])) {
+      lng[i] = NA_REAL;
+      lat[i] = NA_REAL;
+    } else {
+      S2LatLng item(S2Point(x[i], y[i], z[i]));
+      lng[i] = item.lng().degrees();
+      lat[i] = item.lat().degrees();
+    }
+  }
+}
+
+// Cell identifiers are written as the bits of a double (see s2_cell())
+static inline void s2_cell_from_lnglat_batch(const double* lng, const double* lat,
+                                             double* cell_id, R_xlen_t begin,
+                                             R_xlen_t end) {
+  for (R_xlen_t i = begin; i < end; i++) {
+    if (R_IsNA(lng[i]) || R_IsNA(lat[i])) {
+      cell_id[i] = NA_REAL;
+    } else {
+      uint64_t id = S2CellId(S2LatLng::FromDegrees(lat[i], lng[i]).Normalized()).id();
+      memcpy(cell_id + i, &id, sizeof(double));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,153 @@
+
+#include "s2geography/geoarrow.h"
+
+#include "geography.h"
+#include "s2-parallel.h"
+
+#include <Rcpp.h>
+using namespace Rcpp;
+
+static S2::Projection* projectionFromXPtr(SEXP projection_xptr) {
+  if (projection_xptr == R_NilValue) {
+    return nullptr;
+  }
+
+  auto projection = reinterpret_cast<S2::Projection*>(R_ExternalPtrAddr(projection_xptr));
+  if (projection == nullptr) {
+    stop("External ptr to S2::Projection is not valid");
+  }
+
+  return projection;
+}
+
+template <typename T>
+static T* arrowFromXPtr(SEXP xptr, const char* cls) {
+  if (!Rf_inherits(xptr, cls)) {
+    stop("Expected object of class '%s'", cls);
+  }
+
+  T* out = reinterpret_cast<T*>(R_ExternalPtrAddr(xptr));
+  if (out == nullptr) {
+    stop("External pointer to '%s' is not valid", cls);
+  }
+
+  return out;
+}
+
+// Each feature is built independently from the (read-only) array, so
+// features are read in parallel using one Reader per thread.
+// [[Rcpp::export]]
+List cpp_s2_geog_from_geoarrow(SEXP schemaXPtr, SEXP arrayXPtr,
+                               bool oriented, bool check,
+                               SEXP projectionXPtr, double tessellateTolerance,
+                               int numThreads) {
+  auto schema = arrowFromXPtr<struct ArrowSchema>(schemaXPtr, "nanoarrow_schema");
+  auto array = arrowFromXPtr<struct ArrowArray>(arrayXPtr, "nanoarrow_array");
+  if (schema->release == nullptr || array->release == nullptr) {
+    stop("Can't read a released nanoarrow_schema or nanoarrow_array");
+  }
+
+  s2geography::util::Constructor::Options options;
+  options.set_oriented(oriented);
+  options.set_check(check);
+  options.set_projection(projectionFromXPtr(projectionXPtr));
+  if (tessellateTolerance != R_PosInf) {
+    options.set_tessellate_tolerance(S1Angle::Radians(tessellateTolerance));
+  }
+
+  int numReaders = std::max(numThreads, 1);
+  std::vector<std::unique_ptr<s2geography::geoarrow::Reader>> readers;
+  for (int i = 0; i < numReaders; i++) {
+    readers.push_back(absl::make_unique<s2geography::geoarrow::Reader>(options));
+    try {
+      readers.back()->Init(schema);
+    } catch (std::exception& e) {
+      stop(e.what());
+    }
+  }
+
+  std::vector<std::unique_ptr<s2geography::Geography>> features(array->length);
+  try {
+    s2_parallel_for(
+      array->length, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          try {
+            features[i] = readers[worker_id]->ReadFeature(array, i);
+          } catch (s2geography::Exception& e) {
+            throw s2geography::Exception(
+              std::string(e.what()) + " [i = " + std::to_string(i + 1) + "]"
+            );
+          }
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  List output(array->length);
+  for (R_xlen_t i = 0; i < array->length; i++) {
+    if (features[i]) {
+      output[i] = RGeography::MakeXPtr(std::move(features[i]));
+    } else {
+      output[i] = R_NilValue;
+    }
+  }
+
+  return output;
+}
+
+// [[Rcpp::export]]
+void cpp_s2_as_geoarrow(List geog, int geometryType, bool interleaved,
+                        SEXP projectionXPtr, SEXP schemaXPtr, SEXP arrayXPtr) {
+  auto schema = arrowFromXPtr<struct ArrowSchema>(schemaXPtr, "nanoarrow_schema");
+  auto array = arrowFromXPtr<struct ArrowArray>(arrayXPtr, "nanoarrow_array");
+  if (schema->release != nullptr || array->release != nullptr) {
+    stop("Expected a newly allocated nanoarrow_schema and nanoarrow_array");
+  }
+
+  std::vector<const s2geography::Geography*> features(geog.size(), nullptr);
+  for (R_xlen_t i = 0; i < geog.size(); i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features[i] = &feature->Geog();
+    }
+  }
+
+  s2geography::util::Constructor::Options options;
+  options.set_projection(projectionFromXPtr(projectionXPtr));
+
+  try {
+    auto geometry_type = static_cast<s2geography::util::GeometryType>(geometryType);
+    if (geometry_type == s2geography::util::GeometryType::GEOMETRY_TYPE_UNKNOWN) {
+      geometry_type = s2geography::geoarrow::Writer::InferGeometryType(features);
+    }
+
+    s2geography::geoarrow::Writer writer(
+      geometry_type,
+      interleaved ? s2geography::geoarrow::CoordType::INTERLEAVED :
+        s2geography::geoarrow::CoordType::SEPARATED,
+      options
+    );
+
+    for (R_xlen_t i = 0; i < geog.size(); i++) {
+      if ((i % 1000) == 0) {
+        Rcpp::checkUserInterrupt();
+      }
+
+      try {
+        writer.WriteFeature(features[i]);
+      } catch (s2geography::Exception& e) {
+        throw s2geography::Exception(
+          std::string(e.what()) + " [i = " + std::to_string(i + 1) + "]"
+        );
+      }
+    }
+
+    writer.Finish(schema, array);
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+}
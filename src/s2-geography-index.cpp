@@ -0,0 +1,71 @@
+
+#include "s2/util/coding/coder.h"
+
+#include "geography-index.h"
+
+#include <Rcpp.h>
+using namespace Rcpp;
+
+// [[Rcpp::export]]
+SEXP cpp_s2_geography_index(List geog, int maxEdgesPerCell) {
+  auto index = absl::make_unique<RGeographyIndex>(maxEdgesPerCell);
+  index->Add(geog);
+
+  // apply the updates now such that the first query doesn't have to
+  index->Index()->ShapeIndex().ForceBuild();
+
+  // the shapes in the index refer to the features in geog, so geog
+  // must outlive the index
+  return Rcpp::XPtr<RGeographyIndex>(index.release(), true, R_NilValue, geog);
+}
+
+// [[Rcpp::export]]
+RawVector cpp_s2_geography_index_encode(List index) {
+  RGeographyIndex* rindex = RGeographyIndex::Get(index);
+
+  Encoder encoder;
+  try {
+    rindex->Index()->Encode(&encoder);
+  } catch (std::exception& e) {
+    stop(e.what());
+  }
+
+  RawVector out(encoder.length());
+  memcpy(RAW(out), encoder.base(), encoder.length());
+  return out;
+}
+
+// [[Rcpp::export]]
+SEXP cpp_s2_geography_index_decode(List geog, RawVector encoded) {
+  auto index = absl::make_unique<RGeographyIndex>();
+
+  Decoder decoder(RAW(encoded), encoded.size());
+  if (!index->MutableIndex()->Decode(&decoder)) {
+    stop("Failed to decode s2_geography_index");
+  }
+
+  // check that the decoded index refers to the features of geog
+  const s2geography::GeographyIndex& decoded = *index->Index();
+  int shape_id = 0;
+  for (R_xlen_t j = 0; j < geog.size(); j++) {
+    SEXP item = geog[j];
+    if (item == R_NilValue) {
+      stop("Missing `y` not allowed in binary indexed operators()");
+    }
+
+    Rcpp::XPtr<RGeography> feature(item);
+    for (int i = 0; i < feature->Geog().num_shapes(); i++) {
+      if (shape_id >= decoded.num_values() || decoded.value(shape_id) != j) {
+        stop("Encoded s2_geography_index does not match `x`");
+      }
+
+      shape_id++;
+    }
+  }
+
+  if (shape_id != decoded.num_values()) {
+    stop("Encoded s2_geography_index does not match `x`");
+  }
+
+  return Rcpp::XPtr<RGeographyIndex>(index.release(), true, R_NilValue, geog);
+}
@@ -4,6 +4,7 @@
 #include "s2/s2polygon.h"
 
 #include "geography.h"
+#include "s2-parallel.h"
 
 #include <Rcpp.h>
 using namespace Rcpp;
@@ -23,3 +24,58 @@ LogicalVector cpp_s2_geography_is_na(List geog) {
   }
   return out;
 }
+
+// [[Rcpp::export]]
+void cpp_s2_prepare(List geog, int numThreads) {
+  std::vector<RGeography*> features;
+  for (R_xlen_t i = 0; i < geog.size(); i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features.push_back(feature.get());
+    }
+  }
+
+  // the same feature may occur more than once in geog (e.g., after rep()),
+  // which is fine because RGeography::Prepare() is thread safe
+  s2_parallel_for(
+    features.size(), numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      for (R_xlen_t i = begin; i < end; i++) {
+        features[i]->Prepare();
+      }
+    },
+    1
+  );
+}
+
+// Computes and caches the covering of each feature that the matrix and join
+// functions compute (and look up) using the same coverer options and distance
+// (see RGeography::GetCovering())
+// [[Rcpp::export]]
+void cpp_s2_prepare_covering(List geog, int maxCells, double distance, int numThreads) {
+  std::vector<RGeography*> features;
+  for (R_xlen_t i = 0; i < geog.size(); i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features.push_back(feature.get());
+    }
+  }
+
+  S1ChordAngle chordDistance = distance > 0 ? S1ChordAngle::Radians(distance) : S1ChordAngle::Zero();
+  std::vector<S2RegionCoverer> coverers(std::max(numThreads, 1));
+  for (auto& coverer: coverers) {
+    coverer.mutable_options()->set_max_cells(maxCells);
+  }
+
+  s2_parallel_for(
+    features.size(), numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      std::vector<S2CellId> covering;
+      for (R_xlen_t i = begin; i < end; i++) {
+        features[i]->GetCovering(&coverers[worker_id], chordDistance, &covering);
+      }
+    }
+  );
+}
@@ -0,0 +1,566 @@
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2boolean_operation.h"
+#include "s2/s2closest_point_query.h"
+#include "s2/s2contains_point_query.h"
+#include "s2/s2point_index.h"
+#include "s2/s2region_coverer.h"
+
+#include "geography.h"
+#include "geography-points.h"
+#include "s2-options.h"
+#include "s2-parallel.h"
+
+#include <Rcpp.h>
+using namespace Rcpp;
+
+// Finds the pairs of features from geog1 and geog2 that satisfy a predicate
+// using a sort-merge join on the coverings of both sides
+// (s2geography::CoveringJoin) to find candidates, followed by a refinement
+// step using actuallyIntersects(). Coverings and refinement are computed
+// using numThreads threads; the R API is only used to extract features
+// and assemble the result.
+class JoinPairsOperator {
+public:
+  JoinPairsOperator(List s2options, int maxFeatureCells):
+    numThreads(1), maxFeatureCells(maxFeatureCells), keepRelation(false) {
+    GeographyOperationOptions options(s2options);
+    this->options = options.booleanOperationOptions();
+  }
+
+  List processPairs(List geog1, List geog2) {
+    std::vector<RGeography*> features1 = extractFeatures(geog1);
+    std::vector<RGeography*> features2 = extractFeatures(geog2);
+
+    std::vector<std::vector<S2CellId>> coverings1 = this->coverings(features1);
+    std::vector<std::vector<S2CellId>> coverings2 = this->coverings(features2);
+
+    s2geography::CoveringJoin join;
+    for (size_t i = 0; i < features1.size(); i++) {
+      join.AddLeft(coverings1[i], i);
+    }
+    for (size_t j = 0; j < features2.size(); j++) {
+      join.AddRight(coverings2[j], j);
+    }
+
+    std::vector<std::pair<int, int>> candidates;
+    join.Join(&candidates);
+
+    std::vector<int> relations(candidates.size());
+    s2_parallel_for(
+      candidates.size(), this->numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t k = begin; k < end; k++) {
+          int i = candidates[k].first;
+          int j = candidates[k].second;
+          relations[k] = this->relate(features1[i], features2[j], i, j);
+        }
+      }
+    );
+
+    R_xlen_t n = candidates.size() - std::count(relations.begin(), relations.end(), 0);
+    IntegerVector x(n);
+    IntegerVector y(n);
+    IntegerVector relation(n);
+    R_xlen_t k_out = 0;
+    for (size_t k = 0; k < candidates.size(); k++) {
+      if (relations[k] != 0) {
+        // convert to R index here + 1
+        x[k_out] = candidates[k].first + 1;
+        y[k_out] = candidates[k].second + 1;
+        relation[k_out] = relations[k];
+        k_out++;
+      }
+    }
+
+    if (this->keepRelation) {
+      return List::create(_["x"] = x, _["y"] = y, _["relation"] = relation);
+    } else {
+      return List::create(_["x"] = x, _["y"] = y);
+    }
+  }
+
+  virtual bool actuallyIntersects(RGeography* feature1, RGeography* feature2,
+                                  R_xlen_t i, R_xlen_t j) = 0;
+
+  // Pairs are kept if this is nonzero; operators that compute more than one
+  // relationship per pair override this and set keepRelation to return it
+  virtual int relate(RGeography* feature1, RGeography* feature2,
+                     R_xlen_t i, R_xlen_t j) {
+    return this->actuallyIntersects(feature1, feature2, i, j);
+  }
+
+  int numThreads;
+
+protected:
+  S2BooleanOperation::Options options;
+  int maxFeatureCells;
+  bool keepRelation;
+
+  // missing features are left as nullptr and have an empty covering
+  std::vector<RGeography*> extractFeatures(List geog) {
+    std::vector<RGeography*> features(geog.size(), nullptr);
+    for (R_xlen_t i = 0; i < geog.size(); i++) {
+      SEXP item = geog[i];
+      if (item != R_NilValue) {
+        Rcpp::XPtr<RGeography> feature(item);
+        features[i] = feature.get();
+      }
+    }
+
+    return features;
+  }
+
+  std::vector<std::vector<S2CellId>> coverings(const std::vector<RGeography*>& features) {
+    std::vector<S2RegionCoverer> coverers(std::max(this->numThreads, 1));
+    for (auto& coverer: coverers) {
+      coverer.mutable_options()->set_max_cells(this->maxFeatureCells);
+    }
+
+    std::vector<std::vector<S2CellId>> out(features.size());
+    s2_parallel_for(
+      features.size(), this->numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] != nullptr) {
+            features[i]->GetCovering(&coverers[worker_id], S1ChordAngle::Zero(), &out[i]);
+          }
+        }
+      }
+    );
+
+    return out;
+  }
+};
+
+// [[Rcpp::export]]
+List cpp_s2_join_pairs(List geog1, List geog2, std::string predicate,
+                       List s2options, int maxFeatureCells, int numThreads) {
+  class Op: public JoinPairsOperator {
+  public:
+    Op(std::string predicate, List s2options, int maxFeatureCells):
+      JoinPairsOperator(s2options, maxFeatureCells), predicate(predicate) {
+      this->closedOptions = this->options;
+      this->closedOptions.set_polygon_model(S2BooleanOperation::PolygonModel::CLOSED);
+      this->closedOptions.set_polyline_model(S2BooleanOperation::PolylineModel::CLOSED);
+
+      this->openOptions = this->options;
+      this->openOptions.set_polygon_model(S2BooleanOperation::PolygonModel::OPEN);
+      this->openOptions.set_polyline_model(S2BooleanOperation::PolylineModel::OPEN);
+
+      this->points = PointFastPath(this->options);
+      this->closedPoints = PointFastPath(this->closedOptions);
+      this->openPoints = PointFastPath(this->openOptions);
+    }
+
+    bool actuallyIntersects(RGeography* feature1, RGeography* feature2,
+                            R_xlen_t i, R_xlen_t j) {
+      if (predicate == "may_intersect") {
+        return true;
+      }
+
+      bool result;
+      if (actuallyIntersectsPoints(feature1, feature2, &result)) {
+        return result;
+      }
+
+      const s2geography::ShapeIndexGeography& index1 = feature1->Index();
+      const s2geography::ShapeIndexGeography& index2 = feature2->Index();
+      if (predicate == "intersects") {
+        return s2geography::s2_intersects(index1, index2, this->options);
+      } else if (predicate == "contains") {
+        return s2geography::s2_contains(index1, index2, this->options);
+      } else if (predicate == "within") {
+        // note reversed index2, index1
+        return s2geography::s2_contains(index2, index1, this->options);
+      } else if (predicate == "equals") {
+        return s2geography::s2_equals(index1, index2, this->options);
+      } else {
+        // touches
+        return s2geography::s2_relate(index1, index2, this->options,
+                                      s2geography::RELATE_TOUCHES) != 0;
+      }
+    }
+
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      if (predicate == "intersects") {
+        return points.Intersects(feature1, feature2, result);
+      } else if (predicate == "contains") {
+        return points.Contains(feature1, feature2, result);
+      } else if (predicate == "within") {
+        return points.Contains(feature2, feature1, result);
+      } else if (predicate == "equals") {
+        return points.Equals(feature1, feature2, result);
+      } else {
+        // touches
+        bool closedResult, openResult;
+        if (closedPoints.Intersects(feature1, feature2, &closedResult) &&
+            openPoints.Intersects(feature1, feature2, &openResult)) {
+          *result = closedResult && !openResult;
+          return true;
+        } else {
+          return false;
+        }
+      }
+    }
+
+  private:
+    std::string predicate;
+    S2BooleanOperation::Options closedOptions;
+    S2BooleanOperation::Options openOptions;
+    PointFastPath points;
+    PointFastPath closedPoints;
+    PointFastPath openPoints;
+  };
+
+  if (predicate != "may_intersect" && predicate != "intersects" &&
+      predicate != "contains" && predicate != "within" &&
+      predicate != "equals" && predicate != "touches") {
+    stop("Unknown join predicate: '%s'", predicate);
+  }
+
+  Op op(predicate, s2options, maxFeatureCells);
+  op.numThreads = numThreads;
+  return op.processPairs(geog1, geog2);
+}
+
+// Computes all the relationships of each candidate pair at once using
+// s2geography::s2_relate() (which walks the indexes of both features once
+// instead of running one S2BooleanOperation per relationship) and returns the
+// pairs with a nonzero relation code
+// [[Rcpp::export]]
+List cpp_s2_relate_pairs(List geog1, List geog2, List s2options,
+                         int maxFeatureCells, int numThreads) {
+  class Op: public JoinPairsOperator {
+  public:
+    Op(List s2options, int maxFeatureCells):
+      JoinPairsOperator(s2options, maxFeatureCells) {
+      this->keepRelation = true;
+    }
+
+    bool actuallyIntersects(RGeography* feature1, RGeography* feature2,
+                            R_xlen_t i, R_xlen_t j) {
+      return this->relate(feature1, feature2, i, j) != 0;
+    }
+
+    int relate(RGeography* feature1, RGeography* feature2,
+               R_xlen_t i, R_xlen_t j) {
+      return s2geography::s2_relate(feature1->Index(), feature2->Index(), this->options);
+    }
+  };
+
+  Op op(s2options, maxFeatureCells);
+  op.numThreads = numThreads;
+  return op.processPairs(geog1, geog2);
+}
+
+// Finds the k nearest points in geog2 for each feature in geog1 using an
+// S2PointIndex, which is considerably faster to build and query than the
+// MutableS2ShapeIndex used by s2_closest_edges() when geog2 only contains
+// points. The index is built once on the main thread and queried from
+// numThreads threads (one S2ClosestPointQuery per chunk). Points in geog1 are
+// queried using a PointTarget; other features are queried using a
+// ShapeIndexTarget on their index. When a feature in geog2 has more than one
+// point, the query asks for enough points to guarantee k distinct features
+// and only the closest point of each feature is kept.
+// [[Rcpp::export]]
+List cpp_s2_knn_join(SEXP geog1, List geog2, int k, double maxDistance,
+                     int numThreads) {
+  using PointIndex = S2PointIndex<int>;
+  using Query = S2ClosestPointQuery<int>;
+
+  PointIndex index;
+  int maxPointsPerFeature = 1;
+  if (PointVector::IsPointVector(geog2)) {
+    PointVector points(geog2);
+    S2Point point;
+    for (R_xlen_t j = 0; j < points.size(); j++) {
+      if (points.Point(j, &point)) {
+        index.Add(point, j);
+      }
+    }
+  } else {
+    for (R_xlen_t j = 0; j < geog2.size(); j++) {
+      SEXP item = geog2[j];
+      if (item == R_NilValue) {
+        continue;
+      }
+
+      Rcpp::XPtr<RGeography> feature(item);
+      const std::vector<S2Point>* points = PointFastPath::Points(feature.get());
+      if (points == nullptr) {
+        stop("Can't use non-point geography as `y` in s2_knn_join() [j = %d]", (int) j + 1);
+      }
+
+      for (const S2Point& point: *points) {
+        index.Add(point, j);
+      }
+
+      maxPointsPerFeature = std::max<int>(maxPointsPerFeature, points->size());
+    }
+  }
+
+  bool isPointVector = PointVector::IsPointVector(geog1);
+  std::unique_ptr<PointVector> points1;
+  std::vector<RGeography*> features1;
+  R_xlen_t n = PointVector::Length(geog1);
+  if (isPointVector) {
+    points1 = absl::make_unique<PointVector>(geog1);
+  } else {
+    List geog1List(geog1);
+    features1.resize(n, nullptr);
+    for (R_xlen_t i = 0; i < n; i++) {
+      SEXP item = geog1List[i];
+      if (item != R_NilValue) {
+        Rcpp::XPtr<RGeography> feature(item);
+        features1[i] = feature.get();
+      }
+    }
+  }
+
+  Query::Options options;
+  options.set_max_results(std::min<int64_t>((int64_t) k * maxPointsPerFeature,
+                                            std::numeric_limits<int>::max()));
+  options.set_max_distance(S1ChordAngle::Radians(maxDistance));
+
+  std::vector<std::vector<std::pair<int, double>>> neighbours(n);
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        Query query(&index, options);
+        std::vector<Query::Result> results;
+        S2Point point;
+
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (isPointVector) {
+            if (!points1->Point(i, &point)) {
+              continue;
+            }
+
+            Query::PointTarget target(point);
+            query.FindClosestPoints(&target, &results);
+          } else if (features1[i] == nullptr) {
+            continue;
+          } else {
+            const std::vector<S2Point>* points = PointFastPath::Points(features1[i]);
+            if (points != nullptr && points->size() == 1) {
+              Query::PointTarget target((*points)[0]);
+              query.FindClosestPoints(&target, &results);
+            } else {
+              Query::ShapeIndexTarget target(&features1[i]->Index().ShapeIndex());
+              query.FindClosestPoints(&target, &results);
+            }
+          }
+
+          // results are sorted by distance, so the first result for each
+          // feature is its closest point
+          std::vector<std::pair<int, double>>& out = neighbours[i];
+          for (const Query::Result& result: results) {
+            int j = result.data();
+            bool seen = maxPointsPerFeature > 1 &&
+              std::any_of(out.begin(), out.end(), [j](const std::pair<int, double>& item) {
+                return item.first == j;
+              });
+
+            if (!seen) {
+              out.push_back({j, result.distance().ToAngle().radians()});
+              if ((int) out.size() == k) {
+                break;
+              }
+            }
+          }
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  R_xlen_t size = 0;
+  for (const auto& item: neighbours) {
+    size += item.size();
+  }
+
+  IntegerVector x(size);
+  IntegerVector y(size);
+  NumericVector distance(size);
+  R_xlen_t k_out = 0;
+  for (R_xlen_t i = 0; i < n; i++) {
+    for (const auto& item: neighbours[i]) {
+      // convert to R index here + 1
+      x[k_out] = i + 1;
+      y[k_out] = item.first + 1;
+      distance[k_out] = item.second;
+      k_out++;
+    }
+  }
+
+  return List::create(_["x"] = x, _["y"] = y, _["distance"] = distance);
+}
+
+// Finds the polygons in geog2 that contain each point feature in geog1 using
+// one MutableS2ShapeIndex on all of the polygons rather than covering each
+// point and refining each candidate pair using an S2BooleanOperation between
+// two single-feature indexes (like s2_within_matrix()). Each point is
+// answered by one S2ContainsPointQuery::VisitContainingShapes() call using
+// the vertex model that matches the polygon model of s2options (i.e., the
+// same result as PointFastPath::Contains()). Points are sorted by S2CellId
+// first so that consecutive queries visit nearby index cells, and sorted
+// chunks are queried from numThreads threads, each with its own query. A
+// feature with more than one point is only within the polygons that contain
+// all of its points; empty features are never within a polygon.
+// [[Rcpp::export]]
+List cpp_s2_point_in_polygon_join(SEXP geog1, List geog2, List s2options,
+                                  int numThreads) {
+  GeographyOperationOptions options(s2options);
+  S2ContainsPointQueryOptions containsOptions =
+    PointFastPath::ContainsOptions(options.booleanOperationOptions());
+
+  MutableS2ShapeIndex index;
+  std::vector<int> shapeFeature;
+  for (R_xlen_t j = 0; j < geog2.size(); j++) {
+    SEXP item = geog2[j];
+    if (item == R_NilValue) {
+      continue;
+    }
+
+    Rcpp::XPtr<RGeography> feature(item);
+    if (!PointFastPath::IsPolygon(PointFastPath::Feature(feature.get()))) {
+      stop("Can't use non-polygon geography as `y` in s2_point_in_polygon_join() [j = %d]", (int) j + 1);
+    }
+
+    for (int k = 0; k < feature->Geog().num_shapes(); k++) {
+      index.Add(feature->Geog().Shape(k));
+      shapeFeature.push_back(j);
+    }
+  }
+
+  // queries must not build the index concurrently
+  index.ForceBuild();
+
+  bool isPointVector = PointVector::IsPointVector(geog1);
+  std::unique_ptr<PointVector> points1;
+  std::vector<const std::vector<S2Point>*> features1;
+  R_xlen_t n = PointVector::Length(geog1);
+  if (isPointVector) {
+    points1 = absl::make_unique<PointVector>(geog1);
+  } else {
+    List geog1List(geog1);
+    features1.resize(n, nullptr);
+    for (R_xlen_t i = 0; i < n; i++) {
+      SEXP item = geog1List[i];
+      if (item == R_NilValue) {
+        continue;
+      }
+
+      Rcpp::XPtr<RGeography> feature(item);
+      features1[i] = PointFastPath::Points(feature.get());
+      if (features1[i] == nullptr) {
+        stop("Can't use non-point geography as `x` in s2_point_in_polygon_join() [i = %d]", (int) i + 1);
+      }
+    }
+  }
+
+  // Returns the points of feature i (or nullptr if it is missing or empty),
+  // using scratch for the row of a point vector
+  auto featurePoints = [&](R_xlen_t i, std::vector<S2Point>* scratch) -> const std::vector<S2Point>* {
+    if (isPointVector) {
+      scratch->resize(1);
+      return points1->Point(i, &(*scratch)[0]) ? scratch : nullptr;
+    } else if (features1[i] == nullptr || features1[i]->empty()) {
+      return nullptr;
+    } else {
+      return features1[i];
+    }
+  };
+
+  // the cell of the first point of each feature (empty features are sorted
+  // last using the sentinel and dropped)
+  std::vector<std::pair<uint64_t, R_xlen_t>> order(n);
+  s2_parallel_for(
+    n, numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      std::vector<S2Point> scratch;
+      for (R_xlen_t i = begin; i < end; i++) {
+        const std::vector<S2Point>* points = featurePoints(i, &scratch);
+        if (points == nullptr) {
+          order[i] = {S2CellId::Sentinel().id(), i};
+        } else {
+          order[i] = {S2CellId(points->front()).id(), i};
+        }
+      }
+    },
+    4096
+  );
+
+  std::sort(order.begin(), order.end());
+  while (!order.empty() && order.back().first == S2CellId::Sentinel().id()) {
+    order.pop_back();
+  }
+
+  int numWorkers = std::max(numThreads, 1);
+  std::vector<S2ContainsPointQuery<MutableS2ShapeIndex>> queries(numWorkers);
+  for (auto& query: queries) {
+    query.Init(&index, containsOptions);
+  }
+
+  std::vector<std::vector<std::pair<int, int>>> workerPairs(numWorkers);
+  s2_parallel_for(
+    order.size(), numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      S2ContainsPointQuery<MutableS2ShapeIndex>& query = queries[worker_id];
+      std::vector<std::pair<int, int>>& pairs = workerPairs[worker_id];
+      std::vector<S2Point> scratch;
+      std::vector<int> shapeIds;
+
+      for (R_xlen_t k = begin; k < end; k++) {
+        R_xlen_t i = order[k].second;
+        const std::vector<S2Point>& points = *featurePoints(i, &scratch);
+
+        shapeIds.clear();
+        query.VisitContainingShapes(points.front(), [&](S2Shape* shape) {
+          shapeIds.push_back(shape->id());
+          return true;
+        });
+
+        for (size_t p = 1; p < points.size() && !shapeIds.empty(); p++) {
+          shapeIds.erase(
+            std::remove_if(shapeIds.begin(), shapeIds.end(), [&](int shapeId) {
+              return !query.ShapeContains(*index.shape(shapeId), points[p]);
+            }),
+            shapeIds.end()
+          );
+        }
+
+        for (int shapeId: shapeIds) {
+          pairs.push_back({(int) i, shapeFeature[shapeId]});
+        }
+      }
+    },
+    1024
+  );
+
+  std::vector<std::pair<int, int>> pairs;
+  for (auto& item: workerPairs) {
+    pairs.insert(pairs.end(), item.begin(), item.end());
+    std::vector<std::pair<int, int>>().swap(item);
+  }
+
+  std::sort(pairs.begin(), pairs.end());
+
+  IntegerVector x(pairs.size());
+  IntegerVector y(pairs.size());
+  for (size_t k = 0; k < pairs.size(); k++) {
+    // convert to R index here + 1
+    x[k] = pairs[k].first + 1;
+    y[k] = pairs[k].second + 1;
+  }
+
+  return List::create(_["x"] = x, _["y"] = y);
+}
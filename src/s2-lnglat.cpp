@@ -2,60 +2,64 @@
 #include "s2/s2latlng.h"
 #include "s2/s2point.h"
 
+#include "s2-convert.h"
+#include "s2-parallel.h"
+
 #include <Rcpp.h>
 using namespace Rcpp;
 
 #include "wk-v1.h"
 
 // [[Rcpp::export]]
-List s2_lnglat_from_s2_point(List s2_point) {
+List s2_lnglat_from_s2_point(List s2_point, int numThreads) {
   NumericVector x = s2_point[0];
   NumericVector y = s2_point[1];
   NumericVector z = s2_point[2];
 
-  R_len_t n = x.size();
+  R_xlen_t n = x.size();
   NumericVector lng(n);
   NumericVector lat(n);
 
-  S2LatLng item;
-  for (R_xlen_t i = 0; i < n; i++) {
-    if (std::isnan(x[i]) || std::isnan(y[i]) || std::isnan(z[i])) {
-      lng[i] = NA_REAL;
-      lat[i] = NA_REAL;
-    } else {
-      item = S2LatLng(S2Point(x[i], y[i], z[i]));
-      lng[i] = item.lng().degrees();
-      lat[i] = item.lat().degrees();
-    }
-  }
+  const double* px = REAL(x);
+  const double* py = REAL(y);
+  const double* pz = REAL(z);
+  double* plng = REAL(lng);
+  double* plat = REAL(lat);
+
+  s2_parallel_for(
+    n, numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      s2_lnglat_from_point_batch(px, py, pz, plng, plat, begin, end);
+    },
+    4096
+  );
 
   return List::create(_["x"] = lng, _["y"] = lat);
 }
 
 // [[Rcpp::export]]
-List s2_point_from_s2_lnglat(List s2_lnglat) {
+List s2_point_from_s2_lnglat(List s2_lnglat, int numThreads) {
   NumericVector lng = s2_lnglat[0];
   NumericVector lat = s2_lnglat[1];
 
-  R_len_t n = lng.size();
-
+  R_xlen_t n = lng.size();
   NumericVector x(n);
   NumericVector y(n);
   NumericVector z(n);
 
-  S2Point item;
-  for (R_xlen_t i = 0; i < n; i++) {
-    if (std::isnan(lng[i]) || std::isnan(lat[i])) {
-      x[i] = NA_REAL;
-      y[i] = NA_REAL;
-      z[i] = NA_REAL;
-    } else {
-      item = S2LatLng::FromDegrees(lat[i], lng[i]).Normalized().ToPoint();
-      x[i] = item.x();
-      y[i] = item.y();
-      z[i] = item.z();
-    }
-  }
+  const double* plng = REAL(lng);
+  const double* plat = REAL(lat);
+  double* px = REAL(x);
+  double* py = REAL(y);
+  double* pz = REAL(z);
+
+  s2_parallel_for(
+    n, numThreads,
+    [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+      s2_point_from_lnglat_batch(plng, plat, px, py, pz, begin, end);
+    },
+    4096
+  );
 
   return List::create(_["x"] = x, _["y"] = y, _["z"] = z);
 }
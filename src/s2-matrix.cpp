@@ -7,10 +7,12 @@
 #include "s2/s2closest_edge_query.h"
 #include "s2/s2furthest_edge_query.h"
 #include "s2/s2shape_index_region.h"
-#include "s2/s2shape_index_buffered_region.h"
 
 #include "geography-operator.h"
+#include "geography-index.h"
+#include "geography-points.h"
 #include "s2-options.h"
+#include "s2-parallel.h"
 
 #include <Rcpp.h>
 using namespace Rcpp;
@@ -19,7 +21,7 @@ using namespace Rcpp;
 template<class VectorType, class ScalarType>
 class IndexedBinaryGeographyOperator: public UnaryGeographyOperator<VectorType, ScalarType> {
 public:
-  std::unique_ptr<s2geography::GeographyIndex> geog2_index;
+  std::shared_ptr<s2geography::GeographyIndex> geog2_index;
   std::unique_ptr<s2geography::GeographyIndex::Iterator> iterator;
 
   // max_edges_per_cell should be between 10 and 50, with lower numbers
@@ -31,10 +33,18 @@ public:
   IndexedBinaryGeographyOperator(int maxEdgesPerCell = 50) {
     MutableS2ShapeIndex::Options index_options;
     index_options.set_max_edges_per_cell(maxEdgesPerCell);
-    geog2_index = absl::make_unique<s2geography::GeographyIndex>(index_options);
+    geog2_index = std::make_shared<s2geography::GeographyIndex>(index_options);
   }
 
+  // geog2 can also be an s2_geography_index(), in which case its prebuilt
+  // index is used instead of building a new one
   virtual void buildIndex(List geog2) {
+    if (RGeographyIndex::IsIndex(geog2)) {
+      geog2_index = RGeographyIndex::Get(geog2)->Index();
+      iterator = absl::make_unique<s2geography::GeographyIndex::Iterator>(geog2_index.get());
+      return;
+    }
+
     for (R_xlen_t j = 0; j < geog2.size(); j++) {
       checkUserInterrupt();
       SEXP item2 = geog2[j];
@@ -62,8 +72,33 @@ IntegerVector cpp_s2_closest_feature(List geog1, List geog2) {
   public:
     int processFeature(Rcpp::XPtr<RGeography> feature, R_xlen_t i) {
       S2ClosestEdgeQuery query(&geog2_index->ShapeIndex());
-      S2ClosestEdgeQuery::ShapeIndexTarget target(&feature->Index().ShapeIndex());
-      const auto& result = query.FindClosestEdge(&target);
+      auto target = PointFastPath::MakeTarget<S2ClosestEdgeQuery>(feature.get());
+      return closestFeature(&query, target.get());
+    }
+
+    // s2_lnglat() and s2_point() vectors share one query
+    IntegerVector processPoints(SEXP geog1) {
+      PointVector points(geog1);
+      IntegerVector output(points.size());
+      S2ClosestEdgeQuery query(&geog2_index->ShapeIndex());
+
+      S2Point point;
+      for (R_xlen_t i = 0; i < points.size(); i++) {
+        checkUserInterrupt();
+
+        if (!points.Point(i, &point)) {
+          output[i] = NA_INTEGER;
+        } else {
+          S2ClosestEdgeQuery::PointTarget target(point);
+          output[i] = closestFeature(&query, &target);
+        }
+      }
+
+      return output;
+    }
+
+    int closestFeature(S2ClosestEdgeQuery* query, S2ClosestEdgeQuery::Target* target) {
+      const auto& result = query->FindClosestEdge(target);
       if (result.is_empty()) {
         return NA_INTEGER;
       } else {
@@ -75,7 +110,11 @@ IntegerVector cpp_s2_closest_feature(List geog1, List geog2) {
 
   Op op;
   op.buildIndex(geog2);
-  return op.processVector(geog1);
+  if (PointVector::IsPointVector(geog1)) {
+    return op.processPoints(geog1);
+  } else {
+    return op.processVector(geog1);
+  }
 }
 
 // [[Rcpp::export]]
@@ -85,8 +124,8 @@ IntegerVector cpp_s2_farthest_feature(List geog1, List geog2) {
   public:
     int processFeature(Rcpp::XPtr<RGeography> feature, R_xlen_t i) {
       S2FurthestEdgeQuery query(&geog2_index->ShapeIndex());
-      S2FurthestEdgeQuery::ShapeIndexTarget target(&feature->Index().ShapeIndex());
-      const auto& result = query.FindFurthestEdge(&target);
+      auto target = PointFastPath::MakeTarget<S2FurthestEdgeQuery>(feature.get());
+      const auto& result = query.FindFurthestEdge(target.get());
       if (result.is_empty()) {
         return NA_INTEGER;
       } else {
@@ -111,8 +150,8 @@ List cpp_s2_closest_edges(List geog1, List geog2, int n, double min_distance,
       S2ClosestEdgeQuery query(&geog2_index->ShapeIndex());
       query.mutable_options()->set_max_results(n);
       query.mutable_options()->set_max_distance(S1ChordAngle::Radians(max_distance));
-      S2ClosestEdgeQuery::ShapeIndexTarget target(&feature->Index().ShapeIndex());
-      const auto& result = query.FindClosestEdges(&target);
+      auto target = PointFastPath::MakeTarget<S2ClosestEdgeQuery>(feature.get());
+      const auto& result = query.FindClosestEdges(target.get());
 
       // this code searches edges, which may come from the same feature
       std::unordered_set<int> features;
@@ -142,66 +181,174 @@ List cpp_s2_closest_edges(List geog1, List geog2, int n, double min_distance,
 
 class IndexedMatrixPredicateOperator: public IndexedBinaryGeographyOperator<List, IntegerVector> {
 public:
+  // Scratch space used to find the features in geog2 that are related to a
+  // single feature in geog1. When running on more than one thread, each thread
+  // gets its own Worker such that the index on geog2 (which is only read
+  // once built) can be shared.
+  class Worker {
+  public:
+    Worker(const s2geography::GeographyIndex* index, int maxFeatureCells):
+      iterator(index) {
+      coverer.mutable_options()->set_max_cells(maxFeatureCells);
+    }
+
+    s2geography::GeographyIndex::Iterator iterator;
+    S2RegionCoverer coverer;
+    std::vector<S2CellId> cell_ids;
+    std::vector<int> candidates;
+    std::vector<int> indices;
+
+    // a query on the current feature in geog1 that can be reused among its
+    // candidates (used by cpp_s2_dwithin_matrix())
+    S2ClosestEdgeQuery closestEdgeQuery;
+    R_xlen_t closestEdgeQueryRow = -1;
+  };
+
   // a max_cells value of 8 was suggested in the S2RegionCoverer docs as a
   // reasonable approximation of a geometry, although benchmarking seems to indicate that
   // increasing this number above 4 actually decreasses performance (using a value
   // of 1 dramatically decreases performance)
+  IndexedMatrixPredicateOperator(int maxFeatureCells = 4, int maxEdgesPerCell = 50):
+    IndexedBinaryGeographyOperator<List, IntegerVector>(maxEdgesPerCell),
+    numThreads(1),
+    maxFeatureCells(maxFeatureCells) {}
+
   IndexedMatrixPredicateOperator(List s2options, int maxFeatureCells = 4,
                                  int maxEdgesPerCell = 50):
-    IndexedBinaryGeographyOperator<List, IntegerVector>(maxEdgesPerCell),
-    maxFeatureCells(maxFeatureCells) {
+    IndexedMatrixPredicateOperator(maxFeatureCells, maxEdgesPerCell) {
     GeographyOperationOptions options(s2options);
     this->options = options.booleanOperationOptions();
-    this->coverer.mutable_options()->set_max_cells(maxFeatureCells);
+    this->points = PointFastPath(this->options);
   }
 
   void buildIndex(List geog2) {
-    this->geog2  = geog2;
     IndexedBinaryGeographyOperator<List, IntegerVector>::buildIndex(geog2);
+
+    // keep raw pointers to the features so that candidates can be
+    // looked up without touching the R API
+    List features2 = RGeographyIndex::Geography(geog2);
+    geog2Features.resize(features2.size());
+    for (R_xlen_t j = 0; j < features2.size(); j++) {
+      SEXP item2 = features2[j];
+      Rcpp::XPtr<RGeography> feature2(item2);
+      geog2Features[j] = feature2.get();
+    }
+
+    mainWorker = absl::make_unique<Worker>(geog2_index.get(), maxFeatureCells);
+  }
+
+  List processVector(List geog1) {
+    if (this->numThreads <= 1) {
+      return IndexedBinaryGeographyOperator<List, IntegerVector>::processVector(geog1);
+    }
+
+    // extract the features on the main thread; the per-feature indexes are
+    // built by the workers as needed (RGeography::Index() is thread safe)
+    std::vector<RGeography*> features(geog1.size(), nullptr);
+    for (R_xlen_t i = 0; i < geog1.size(); i++) {
+      SEXP item = geog1[i];
+      if (item != R_NilValue) {
+        Rcpp::XPtr<RGeography> feature(item);
+        features[i] = feature.get();
+      }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int k = 0; k < this->numThreads; k++) {
+      workers.push_back(absl::make_unique<Worker>(geog2_index.get(), maxFeatureCells));
+    }
+
+    std::vector<std::vector<int>> results(geog1.size());
+    s2_parallel_for(
+      geog1.size(), this->numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        Worker* worker = workers[worker_id].get();
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] != nullptr) {
+            this->findIndices(features[i], i, worker);
+            results[i] = worker->indices;
+          }
+        }
+      }
+    );
+
+    List output(geog1.size());
+    for (R_xlen_t i = 0; i < geog1.size(); i++) {
+      if (features[i] == nullptr) {
+        output[i] = R_NilValue;
+      } else {
+        output[i] = IntegerVector(results[i].begin(), results[i].end());
+      }
+    }
+
+    return output;
   }
 
   IntegerVector processFeature(Rcpp::XPtr<RGeography> feature, R_xlen_t i) {
-    coverer.GetCovering(*feature->Geog().Region(), &cell_ids);
-    indices_unsorted.clear();
-    iterator->Query(cell_ids, &indices_unsorted);
+    findIndices(feature.get(), i, mainWorker.get());
+    return Rcpp::IntegerVector(mainWorker->indices.begin(), mainWorker->indices.end());
+  };
+
+  // Populates worker->indices with the sorted (R) indices of the features in
+  // geog2 that relate to feature. This is called from worker threads and
+  // must not use the R API.
+  void findIndices(RGeography* feature, R_xlen_t i, Worker* worker) {
+    this->getCovering(feature, worker);
+    worker->candidates.clear();
+    worker->iterator.Query(worker->cell_ids, &worker->candidates);
 
     // loop through features from geog2 that might intersect feature
     // and build a list of indices that actually intersect (based on
     // this->actuallyIntersects(), which might perform alternative
     // comparisons)
-    indices.clear();
-    for (int j: indices_unsorted) {
-      SEXP item = this->geog2[j];
-      XPtr<RGeography> feature2(item);
+    worker->indices.clear();
+    for (int j: worker->candidates) {
+      RGeography* feature2 = geog2Features[j];
+
+      bool result;
+      if (!this->actuallyIntersectsPoints(feature, feature2, &result)) {
+        result = this->actuallyIntersects(feature->Index(), feature2->Index(), i, j, worker);
+      }
 
-      if (this->actuallyIntersects(feature->Index(), feature2->Index(), i, j)) {
+      if (result) {
         // convert to R index here + 1
-        indices.push_back(j + 1);
+        worker->indices.push_back(j + 1);
       }
     }
 
-    // return sorted integer vector
-    std::sort(indices.begin(), indices.end());
-    return Rcpp::IntegerVector(indices.begin(), indices.end());
-  };
+    std::sort(worker->indices.begin(), worker->indices.end());
+  }
+
+  virtual void getCovering(RGeography* feature, Worker* worker) {
+    feature->GetCovering(&worker->coverer, S1ChordAngle::Zero(), &worker->cell_ids);
+  }
 
   virtual bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) = 0;
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) = 0;
+
+  // Subclasses can override this to compute the result without an index
+  // on feature1 or feature2 when one of them is a point (see PointFastPath).
+  // Returns false if actuallyIntersects() should be used instead.
+  virtual bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                        bool* result) {
+    return false;
+  }
+
+  int numThreads;
 
   protected:
-    List geog2;
+    std::vector<RGeography*> geog2Features;
     S2BooleanOperation::Options options;
+    PointFastPath points;
     int maxFeatureCells;
-    S2RegionCoverer coverer;
-    std::vector<S2CellId> cell_ids;
-    std::unordered_set<int> indices_unsorted;
-    std::vector<int> indices;
+    std::unique_ptr<Worker> mainWorker;
 };
 
 // [[Rcpp::export]]
 List cpp_s2_may_intersect_matrix(List geog1, List geog2,
-                                 int maxEdgesPerCell, int maxFeatureCells, List s2options) {
+                                 int maxEdgesPerCell, int maxFeatureCells, List s2options,
+                                 int numThreads) {
   class Op: public IndexedMatrixPredicateOperator {
   public:
     Op(List s2options, int maxFeatureCells, int maxEdgesPerCell):
@@ -209,87 +356,112 @@ List cpp_s2_may_intersect_matrix(List geog1, List geog2,
 
     bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) {
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) {
       return true;
     };
   };
 
   Op op(s2options, maxFeatureCells, maxEdgesPerCell);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
 
 // [[Rcpp::export]]
-List cpp_s2_contains_matrix(List geog1, List geog2, List s2options) {
+List cpp_s2_contains_matrix(List geog1, List geog2, List s2options, int numThreads) {
   class Op: public IndexedMatrixPredicateOperator {
   public:
     Op(List s2options): IndexedMatrixPredicateOperator(s2options) {}
     bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) {
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) {
       return s2geography::s2_contains(index1, index2, this->options);
     };
+
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      return this->points.Contains(feature1, feature2, result);
+    }
   };
 
   Op op(s2options);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
 
 // [[Rcpp::export]]
-List cpp_s2_within_matrix(List geog1, List geog2, List s2options) {
+List cpp_s2_within_matrix(List geog1, List geog2, List s2options, int numThreads) {
   class Op: public IndexedMatrixPredicateOperator {
   public:
     Op(List s2options): IndexedMatrixPredicateOperator(s2options) {}
     bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) {
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) {
       // note reversed index2, index1
       return s2geography::s2_contains(index2, index1, this->options);
     };
+
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      return this->points.Contains(feature2, feature1, result);
+    }
   };
 
   Op op(s2options);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
 
 // [[Rcpp::export]]
-List cpp_s2_intersects_matrix(List geog1, List geog2, List s2options) {
+List cpp_s2_intersects_matrix(List geog1, List geog2, List s2options, int numThreads) {
   class Op: public IndexedMatrixPredicateOperator {
   public:
     Op(List s2options): IndexedMatrixPredicateOperator(s2options) {}
     bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) {
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) {
       return s2geography::s2_intersects(index1, index2, this->options);
     };
+
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      return this->points.Intersects(feature1, feature2, result);
+    }
   };
 
   Op op(s2options);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
 
 // [[Rcpp::export]]
-List cpp_s2_equals_matrix(List geog1, List geog2, List s2options) {
+List cpp_s2_equals_matrix(List geog1, List geog2, List s2options, int numThreads) {
   class Op: public IndexedMatrixPredicateOperator {
   public:
     Op(List s2options): IndexedMatrixPredicateOperator(s2options) {}
     bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) {
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) {
       return s2geography::s2_equals(index1, index2, this->options);
     };
+
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      return this->points.Equals(feature1, feature2, result);
+    }
   };
 
   Op op(s2options);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
 
 // [[Rcpp::export]]
-List cpp_s2_touches_matrix(List geog1, List geog2, List s2options) {
+List cpp_s2_touches_matrix(List geog1, List geog2, List s2options, int numThreads) {
   class Op: public IndexedMatrixPredicateOperator {
   public:
     Op(List s2options): IndexedMatrixPredicateOperator(s2options) {
@@ -300,21 +472,39 @@ List cpp_s2_touches_matrix(List geog1, List geog2, List s2options) {
       this->openOptions = this->options;
       this->openOptions.set_polygon_model(S2BooleanOperation::PolygonModel::OPEN);
       this->openOptions.set_polyline_model(S2BooleanOperation::PolylineModel::OPEN);
+
+      this->closedPoints = PointFastPath(this->closedOptions);
+      this->openPoints = PointFastPath(this->openOptions);
     }
 
     bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
                                   const s2geography::ShapeIndexGeography& index2,
-                                  R_xlen_t i, R_xlen_t j) {
-      return s2geography::s2_intersects(index1, index2, this->closedOptions) &&
-        !s2geography::s2_intersects(index1, index2, this->openOptions);
+                                  R_xlen_t i, R_xlen_t j, Worker* worker) {
+      return s2geography::s2_relate(index1, index2, this->options,
+                                    s2geography::RELATE_TOUCHES) != 0;
     };
 
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      bool closedResult, openResult;
+      if (closedPoints.Intersects(feature1, feature2, &closedResult) &&
+          openPoints.Intersects(feature1, feature2, &openResult)) {
+        *result = closedResult && !openResult;
+        return true;
+      } else {
+        return false;
+      }
+    }
+
   private:
     S2BooleanOperation::Options closedOptions;
     S2BooleanOperation::Options openOptions;
+    PointFastPath closedPoints;
+    PointFastPath openPoints;
   };
 
   Op op(s2options);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
@@ -382,146 +572,281 @@ public:
 };
 
 // [[Rcpp::export]]
-List cpp_s2_dwithin_matrix(List geog1, List geog2, double distance) {
-  class Op: public IndexedBinaryGeographyOperator<List, IntegerVector> {
+List cpp_s2_dwithin_matrix(List geog1, List geog2, double distance, int numThreads) {
+  class Op: public IndexedMatrixPredicateOperator {
   public:
-    List geog2;
-    S2RegionCoverer coverer;
-    std::vector<S2CellId> cell_ids;
-    std::unordered_set<int> indices_unsorted;
-    std::vector<int> indices;
     S1ChordAngle distance;
 
-    IntegerVector processFeature(Rcpp::XPtr<RGeography> feature1, R_xlen_t i) {
-      S2ShapeIndexBufferedRegion buffered(
-        &feature1->Index().ShapeIndex(),
-        this->distance
-      );
-      coverer.GetCovering(buffered, &cell_ids);
+    // use the S2RegionCoverer default of 8 cells to cover the buffered feature
+    Op(double distance): IndexedMatrixPredicateOperator(8),
+      distance(S1ChordAngle::Radians(distance)) {}
 
-      indices_unsorted.clear();
-      iterator->Query(cell_ids, &indices_unsorted);
-
-      S2ClosestEdgeQuery query(&feature1->Index().ShapeIndex());
-
-      indices.clear();
-
-      for (int j: indices_unsorted) {
-        SEXP item = this->geog2[j];
-        XPtr<RGeography> feature2(item);
+    void getCovering(RGeography* feature, Worker* worker) {
+      feature->GetCovering(&worker->coverer, this->distance, &worker->cell_ids);
+    }
 
-        S2ClosestEdgeQuery::ShapeIndexTarget target(&feature2->Index().ShapeIndex());
-        if (query.IsDistanceLessOrEqual(&target, this->distance)) {
-          indices.push_back(j + 1);
-        }
+    bool actuallyIntersects(const s2geography::ShapeIndexGeography& index1,
+                            const s2geography::ShapeIndexGeography& index2,
+                            R_xlen_t i, R_xlen_t j, Worker* worker) {
+      // only rebuild the query on feature1 when moving on to the next row
+      if (worker->closestEdgeQueryRow != i) {
+        worker->closestEdgeQuery.Init(&index1.ShapeIndex());
+        worker->closestEdgeQueryRow = i;
       }
 
-      // return sorted integer vector
-      std::sort(indices.begin(), indices.end());
-      return Rcpp::IntegerVector(indices.begin(), indices.end());
+      S2ClosestEdgeQuery::ShapeIndexTarget target(&index2.ShapeIndex());
+      return worker->closestEdgeQuery.IsDistanceLessOrEqual(&target, this->distance);
+    }
+
+    bool actuallyIntersectsPoints(RGeography* feature1, RGeography* feature2,
+                                  bool* result) {
+      return this->points.IsDistanceLessOrEqual(feature1, feature2, this->distance, result);
     }
   };
 
-  Op op;
-  op.geog2 = geog2;
-  op.distance = S1ChordAngle::Radians(distance);
+  Op op(distance);
+  op.numThreads = numThreads;
   op.buildIndex(geog2);
   return op.processVector(geog1);
 }
 
 // ----------- distance matrix operators -------------------
 
+// Computes a value for every pair of features in geog1 and geog2. The matrix
+// is processed in tiles of rows and columns that are distributed among
+// numThreads threads; within a tile, values are computed a column at a
+// time so that the output (a column-major R matrix) is written
+// sequentially. Subclasses can override processTile() to reuse
+// work among the features in a tile.
 template<class MatrixType, class ScalarType>
 class MatrixGeographyOperator {
 public:
+  MatrixGeographyOperator(): numThreads(1) {}
+
   MatrixType processVector(Rcpp::List geog1, Rcpp::List geog2) {
+    std::vector<RGeography*> features1 = extractFeatures(geog1);
+    std::vector<RGeography*> features2 = extractFeatures(geog2);
+
+    R_xlen_t n1 = geog1.size();
+    R_xlen_t n2 = geog2.size();
+    MatrixType output(n1, n2);
+    ScalarType* out = output.begin();
+
+    R_xlen_t tileRows = (n1 + tileSize - 1) / tileSize;
+    R_xlen_t tileCols = (n2 + tileSize - 1) / tileSize;
+
+    s2_parallel_for(
+      tileRows * tileCols, this->numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t tile = begin; tile < end; tile++) {
+          R_xlen_t iBegin = (tile % tileRows) * tileSize;
+          R_xlen_t jBegin = (tile / tileRows) * tileSize;
+          this->processTile(
+            features1, iBegin, std::min<R_xlen_t>(n1, iBegin + tileSize),
+            features2, jBegin, std::min<R_xlen_t>(n2, jBegin + tileSize),
+            out, n1
+          );
+        }
+      },
+      1
+    );
+
+    return output;
+  }
 
-    MatrixType output(geog1.size(), geog2.size());
+  // Sets out[i + j * n1] for all i in [iBegin, iEnd) and j in [jBegin, jEnd).
+  // This is called from worker threads and must not use the R API.
+  virtual void processTile(const std::vector<RGeography*>& features1,
+                           R_xlen_t iBegin, R_xlen_t iEnd,
+                           const std::vector<RGeography*>& features2,
+                           R_xlen_t jBegin, R_xlen_t jEnd,
+                           ScalarType* out, R_xlen_t n1) {
+    for (R_xlen_t j = jBegin; j < jEnd; j++) {
+      for (R_xlen_t i = iBegin; i < iEnd; i++) {
+        if (features1[i] == nullptr || features2[j] == nullptr) {
+          out[i + j * n1] = MatrixType::get_na();
+        } else {
+          out[i + j * n1] = this->processFeature(features1[i], features2[j], i, j);
+        }
+      }
+    }
+  }
 
-    SEXP item1;
-    SEXP item2;
+  virtual ScalarType processFeature(RGeography* feature1, RGeography* feature2,
+                                    R_xlen_t i, R_xlen_t j) = 0;
 
-    for (R_xlen_t i = 0; i < geog1.size(); i++) {
-      item1 = geog1[i];
-      if (item1 ==  R_NilValue) {
-        for (R_xlen_t j = 0; j < geog2.size(); j++) {
-          output(i, j) = MatrixType::get_na();
+  int numThreads;
+
+protected:
+  // large enough to amortize the per-tile setup but small enough that the
+  // queries and targets for a tile stay in cache
+  static const R_xlen_t tileSize = 64;
+
+  std::vector<RGeography*> extractFeatures(Rcpp::List geog) {
+    std::vector<RGeography*> features(geog.size(), nullptr);
+    for (R_xlen_t i = 0; i < geog.size(); i++) {
+      SEXP item = geog[i];
+      if (item != R_NilValue) {
+        Rcpp::XPtr<RGeography> feature(item);
+        features[i] = feature.get();
+      }
+    }
+
+    return features;
+  }
+};
+
+// Minimum (S2ClosestEdgeQuery) or maximum (S2FurthestEdgeQuery) distance
+// matrix in radians. Queries are created at most once for each row and each
+// column of a tile and reused. Point features are never indexed: the
+// distance between two point features is computed directly from the chord
+// angles between the points and the distance between a point feature and
+// any other feature uses a PointTarget for each point (see PointFastPath).
+template<class Query, class Traits>
+class DistanceMatrixOperator: public MatrixGeographyOperator<NumericMatrix, double> {
+public:
+  void processTile(const std::vector<RGeography*>& features1,
+                   R_xlen_t iBegin, R_xlen_t iEnd,
+                   const std::vector<RGeography*>& features2,
+                   R_xlen_t jBegin, R_xlen_t jEnd,
+                   double* out, R_xlen_t n1) {
+    std::vector<const std::vector<S2Point>*> points1(iEnd - iBegin, nullptr);
+    std::vector<std::unique_ptr<Query>> queries1(iEnd - iBegin);
+    for (R_xlen_t i = iBegin; i < iEnd; i++) {
+      if (features1[i] != nullptr) {
+        points1[i - iBegin] = PointFastPath::Points(features1[i]);
+      }
+    }
+
+    for (R_xlen_t j = jBegin; j < jEnd; j++) {
+      double* outCol = out + j * n1;
+
+      if (features2[j] == nullptr) {
+        for (R_xlen_t i = iBegin; i < iEnd; i++) {
+          outCol[i] = NA_REAL;
         }
-      } else {
-        Rcpp::XPtr<RGeography> feature1(item1);
 
-        for (R_xlen_t j = 0; j < geog2.size(); j++) {
-          checkUserInterrupt();
-          item2 = geog2[j];
+        continue;
+      }
 
-          if (item2 == R_NilValue) {
-            output(i, j) = MatrixType::get_na();
-          } else {
-            Rcpp::XPtr<RGeography> feature2(item2);
-            output(i, j) = this->processFeature(feature1, feature2, i, j);
+      const std::vector<S2Point>* points2 = PointFastPath::Points(features2[j]);
+      std::unique_ptr<Query> query2;
+      std::unique_ptr<typename Query::ShapeIndexTarget> target2;
+
+      for (R_xlen_t i = iBegin; i < iEnd; i++) {
+        if (features1[i] == nullptr) {
+          outCol[i] = NA_REAL;
+          continue;
+        }
+
+        const std::vector<S2Point>* points = points1[i - iBegin];
+        std::unique_ptr<Query>& query1 = queries1[i - iBegin];
+        if (points == nullptr && !query1) {
+          query1 = absl::make_unique<Query>(&features1[i]->Index().ShapeIndex());
+        }
+
+        S1ChordAngle angle;
+        if (points != nullptr && points2 != nullptr) {
+          angle = Traits::PointsDistance(*points, *points2);
+        } else if (points != nullptr) {
+          if (!query2) {
+            query2 = absl::make_unique<Query>(&features2[j]->Index().ShapeIndex());
+          }
+
+          angle = Traits::PointsDistance(query2.get(), *points);
+        } else if (points2 != nullptr) {
+          angle = Traits::PointsDistance(query1.get(), *points2);
+        } else {
+          if (!target2) {
+            target2 = absl::make_unique<typename Query::ShapeIndexTarget>(
+              &features2[j]->Index().ShapeIndex()
+            );
           }
+
+          angle = Traits::FindDistance(query1.get(), target2.get());
         }
+
+        outCol[i] = Traits::ToRadians(angle);
       }
     }
+  }
 
-    return output;
+  double processFeature(RGeography* feature1, RGeography* feature2,
+                        R_xlen_t i, R_xlen_t j) {
+    Query query(&feature1->Index().ShapeIndex());
+    typename Query::ShapeIndexTarget target(&feature2->Index().ShapeIndex());
+    return Traits::ToRadians(Traits::FindDistance(&query, &target));
   }
+};
 
-  virtual ScalarType processFeature(Rcpp::XPtr<RGeography> feature1,
-                                    Rcpp::XPtr<RGeography> feature2,
-                                    R_xlen_t i, R_xlen_t j) = 0;
+struct ClosestDistanceTraits {
+  static S1ChordAngle FindDistance(S2ClosestEdgeQuery* query,
+                                   S2ClosestEdgeQuery::ShapeIndexTarget* target) {
+    return query->FindClosestEdge(target).distance();
+  }
+
+  static S1ChordAngle PointsDistance(const std::vector<S2Point>& points1,
+                                     const std::vector<S2Point>& points2) {
+    return PointFastPath::MinDistance(points1, points2);
+  }
+
+  static S1ChordAngle PointsDistance(S2ClosestEdgeQuery* query,
+                                     const std::vector<S2Point>& points) {
+    return PointFastPath::MinDistance(query, points);
+  }
+
+  static double ToRadians(S1ChordAngle angle) {
+    double distance = angle.ToAngle().radians();
+
+    if (distance == R_PosInf) {
+      return NA_REAL;
+    } else {
+      return distance;
+    }
+  }
 };
 
-// [[Rcpp::export]]
-NumericMatrix cpp_s2_distance_matrix(List geog1, List geog2) {
-  class Op: public MatrixGeographyOperator<NumericMatrix, double> {
+struct FurthestDistanceTraits {
+  static S1ChordAngle FindDistance(S2FurthestEdgeQuery* query,
+                                   S2FurthestEdgeQuery::ShapeIndexTarget* target) {
+    return query->FindFurthestEdge(target).distance();
+  }
+
+  static S1ChordAngle PointsDistance(const std::vector<S2Point>& points1,
+                                     const std::vector<S2Point>& points2) {
+    return PointFastPath::MaxDistance(points1, points2);
+  }
 
-    double processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2,
-                          R_xlen_t i, R_xlen_t j) {
-      S2ClosestEdgeQuery query(&feature1->Index().ShapeIndex());
-      S2ClosestEdgeQuery::ShapeIndexTarget target(&feature2->Index().ShapeIndex());
-      const auto& result = query.FindClosestEdge(&target);
+  static S1ChordAngle PointsDistance(S2FurthestEdgeQuery* query,
+                                     const std::vector<S2Point>& points) {
+    return PointFastPath::MaxDistance(query, points);
+  }
 
-      S1ChordAngle angle = result.distance();
-      double distance = angle.ToAngle().radians();
+  static double ToRadians(S1ChordAngle angle) {
+    double distance = angle.ToAngle().radians();
 
-      if (distance == R_PosInf) {
-        return NA_REAL;
-      } else {
-        return distance;
-      }
+    // returns -1 if one of the indexes is empty
+    // NA is more consistent with the BigQuery
+    // function, and makes way more sense
+    if (distance < 0) {
+      return NA_REAL;
+    } else {
+      return distance;
     }
-  };
+  }
+};
 
-  Op op;
+// [[Rcpp::export]]
+NumericMatrix cpp_s2_distance_matrix(List geog1, List geog2, int numThreads) {
+  DistanceMatrixOperator<S2ClosestEdgeQuery, ClosestDistanceTraits> op;
+  op.numThreads = numThreads;
   return op.processVector(geog1, geog2);
 }
 
 // [[Rcpp::export]]
-NumericMatrix cpp_s2_max_distance_matrix(List geog1, List geog2) {
-  class Op: public MatrixGeographyOperator<NumericMatrix, double> {
-
-    double processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2,
-                          R_xlen_t i, R_xlen_t j) {
-      S2FurthestEdgeQuery query(&feature1->Index().ShapeIndex());
-      S2FurthestEdgeQuery::ShapeIndexTarget target(&feature2->Index().ShapeIndex());
-      const auto& result = query.FindFurthestEdge(&target);
-
-      S1ChordAngle angle = result.distance();
-      double distance = angle.ToAngle().radians();
-
-      // returns -1 if one of the indexes is empty
-      // NA is more consistent with the BigQuery
-      // function, and makes way more sense
-      if (distance < 0) {
-        return NA_REAL;
-      } else {
-        return distance;
-      }
-    }
-  };
-
-  Op op;
+NumericMatrix cpp_s2_max_distance_matrix(List geog1, List geog2, int numThreads) {
+  DistanceMatrixOperator<S2FurthestEdgeQuery, FurthestDistanceTraits> op;
+  op.numThreads = numThreads;
   return op.processVector(geog1, geog2);
 }
 
@@ -621,3 +946,46 @@ List cpp_s2_dwithin_matrix_brute_force(List geog1, List geog2, double distance)
   Op op(distance);
   return op.processVector(geog1, geog2);
 }
+
+// ----------- index query candidate collection (for benchmarking) ------------------
+
+// Returns the number of candidates from geog2 for each feature in geog1, collecting
+// them using the std::unordered_set<int> (useSet = true) or std::vector<int>
+// overload of GeographyIndex::Iterator::Query() (see data-raw/bench-index-query.R)
+// [[Rcpp::export]]
+IntegerVector cpp_s2_index_query_candidates(List geog1, List geog2, int maxFeatureCells,
+                                            bool useSet) {
+  class Op: public IndexedBinaryGeographyOperator<IntegerVector, int> {
+  public:
+    Op(int maxFeatureCells, bool useSet): useSet(useSet) {
+      coverer.mutable_options()->set_max_cells(maxFeatureCells);
+    }
+
+    int processFeature(XPtr<RGeography> feature, R_xlen_t i) {
+      coverer.GetCovering(*feature->Geog().Region(), &cell_ids);
+
+      if (useSet) {
+        indices_unsorted.clear();
+        iterator->Query(cell_ids, &indices_unsorted);
+        indices.assign(indices_unsorted.begin(), indices_unsorted.end());
+      } else {
+        indices.clear();
+        iterator->Query(cell_ids, &indices);
+      }
+
+      std::sort(indices.begin(), indices.end());
+      return indices.size();
+    }
+
+  private:
+    bool useSet;
+    S2RegionCoverer coverer;
+    std::vector<S2CellId> cell_ids;
+    std::unordered_set<int> indices_unsorted;
+    std::vector<int> indices;
+  };
+
+  Op op(maxFeatureCells, useSet);
+  op.buildIndex(geog2);
+  return op.processVector(geog1);
+}
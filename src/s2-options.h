@@ -11,6 +11,14 @@
 #include "s2/s2builderutil_s2point_vector_layer.h"
 
 #include "s2geography.h"
+#include "s2-parallel.h"
+
+// The memory budget of the most recent operation that used
+// GeographyOperationOptions::geographyOptions() (see s2_max_memory_usage())
+inline std::shared_ptr<s2geography::MemoryBudget>& s2_last_memory_budget() {
+  static std::shared_ptr<s2geography::MemoryBudget> budget;
+  return budget;
+}
 
 // This class wraps several concepts in the S2BooleanOperation,
 // and S2Layer, parameterized such that these can be specified from R
@@ -33,6 +41,7 @@ public:
   int splitCrossingEdges;
   int idempotent;
   int dimensions;
+  double memoryLimit;
 
   enum Dimension {
     POINT = 1,
@@ -50,7 +59,8 @@ public:
   };
 
   // deaults: use S2 defaults
-  GeographyOperationOptions(): polygonModel(-1), polylineModel(-1), snapRadius(-1) {
+  GeographyOperationOptions(): polygonModel(-1), polylineModel(-1), snapRadius(-1),
+    memoryLimit(R_PosInf) {
     this->snap.attr("class") = "snap_identity";
   }
 
@@ -180,6 +190,17 @@ public:
       err << "Error setting s2_options() `dimensions`: " << e.what();
       Rcpp::stop(err.str());
     }
+
+    // s2_options() objects created by older versions don't have a memory limit
+    if (s2options.containsElementNamed("memory_limit")) {
+      try {
+        this->memoryLimit = s2options["memory_limit"];
+      } catch (std::exception& e) {
+        std::stringstream err;
+        err << "Error setting s2_options() `memory_limit`: " << e.what();
+        Rcpp::stop(err.str());
+      }
+    }
   }
 
   // build options for passing this to the S2BooleanOperation
@@ -219,6 +240,18 @@ public:
       options.polygon_layer_action = s2geography::GlobalOptions::OUTPUT_ACTION_IGNORE;
     }
 
+    // Memory is tracked for every operation such that the peak usage can be
+    // reported; the interrupt callback lets a user interrupt cancel an
+    // operation on a single (possibly very large) feature.
+    int64_t limit = S2MemoryTracker::kNoLimit;
+    if (this->memoryLimit < (double) S2MemoryTracker::kNoLimit) {
+      limit = this->memoryLimit;
+    }
+
+    options.memory_budget = std::make_shared<s2geography::MemoryBudget>(limit);
+    options.memory_budget->set_interrupt_callback(1 << 20, &s2_cancel_requested);
+    s2_last_memory_budget() = options.memory_budget;
+
     return options;
   }
 
@@ -0,0 +1,150 @@
+#ifndef S2_PARALLEL_H
+#define S2_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Rcpp.h>
+
+// Used to check for a user interrupt without a longjmp (R_CheckUserInterrupt()
+// will longjmp if there is an interrupt pending, which would skip joining
+// any worker threads)
+static inline void s2_check_interrupt_fn(void* dummy) {
+  R_CheckUserInterrupt();
+}
+
+static inline bool s2_interrupt_pending() {
+  return R_ToplevelExec(s2_check_interrupt_fn, nullptr) == FALSE;
+}
+
+// Points to the cancelled flag of the s2_parallel_for() that is running
+// on the current thread (or nullptr on the main R thread)
+inline std::atomic<bool>*& s2_worker_cancelled_flag() {
+  thread_local std::atomic<bool>* flag = nullptr;
+  return flag;
+}
+
+// Returns true if a long-running operation should stop: on a worker thread,
+// this happens when the main thread detects a user interrupt (or another
+// worker fails); on the main R thread, this checks for a user interrupt
+// directly. Unlike Rcpp::checkUserInterrupt(), this is safe to call from
+// any thread and never longjmps. Note that an interrupt detected on the main
+// thread is consumed, so callers should report an error when this returns
+// true.
+inline bool s2_cancel_requested() {
+  std::atomic<bool>* flag = s2_worker_cancelled_flag();
+  if (flag != nullptr) {
+    return flag->load();
+  } else {
+    return s2_interrupt_pending();
+  }
+}
+
+// Calls func(worker_id, begin, end) for chunks of [0, n) using up to
+// num_threads threads, where 0 <= worker_id < num_threads can be used to look
+// up scratch space that belongs to a single thread. Because func may be called
+// from a thread other than the main R thread, it must not touch the R API
+// (including Rcpp vectors, Rcpp::XPtr, Rcpp::stop(), and
+// Rcpp::checkUserInterrupt()): any data needed from R objects should be
+// extracted before calling s2_parallel_for() and the R result should be
+// assembled afterward. The main thread waits for the workers and checks for
+// user interrupts while it does so. An interrupt or an exception thrown by
+// func stops workers from starting new chunks and is rethrown on the main
+// thread after all workers have finished. With num_threads <= 1, chunks are
+// processed in order on the main thread.
+template <typename Func>
+void s2_parallel_for(R_xlen_t n, int num_threads, Func func,
+                     R_xlen_t chunk_size = 64) {
+  if (n <= 0) {
+    return;
+  }
+
+  R_xlen_t num_chunks = (n + chunk_size - 1) / chunk_size;
+  if (num_threads > num_chunks) {
+    num_threads = num_chunks;
+  }
+
+  if (num_threads <= 1) {
+    for (R_xlen_t begin = 0; begin < n; begin += chunk_size) {
+      Rcpp::checkUserInterrupt();
+      func(0, begin, std::min<R_xlen_t>(n, begin + chunk_size));
+    }
+
+    return;
+  }
+
+  std::atomic<R_xlen_t> next_chunk(0);
+  std::atomic<bool> cancelled(false);
+  int num_running = num_threads;
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable finished;
+
+  auto worker = [&](int worker_id) {
+    s2_worker_cancelled_flag() = &cancelled;
+    try {
+      while (!cancelled) {
+        R_xlen_t begin = next_chunk.fetch_add(1) * chunk_size;
+        if (begin >= n) {
+          break;
+        }
+
+        func(worker_id, begin, std::min<R_xlen_t>(n, begin + chunk_size));
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+
+      cancelled = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    num_running--;
+    finished.notify_all();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back(worker, i);
+  }
+
+  bool interrupted = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (num_running > 0) {
+      finished.wait_for(lock, std::chrono::milliseconds(100));
+      if (num_running > 0 && !interrupted) {
+        lock.unlock();
+        interrupted = s2_interrupt_pending();
+        lock.lock();
+
+        if (interrupted) {
+          cancelled = true;
+        }
+      }
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  if (interrupted) {
+    throw Rcpp::internal::InterruptedException();
+  }
+}
+
+#endif
@@ -7,18 +7,24 @@
 #include "s2/s2shape_index_buffered_region.h"
 
 #include "geography-operator.h"
+#include "geography-points.h"
 #include "s2-options.h"
 
 #include <Rcpp.h>
 using namespace Rcpp;
 
-class BinaryPredicateOperator: public BinaryGeographyOperator<LogicalVector, int> {
+// Predicates accept s2_geography() vectors and point vectors (s2_lnglat() or
+// s2_point()). Relations that involve a point are computed using
+// PointFastPath where possible.
+class BinaryPredicateOperator: public BinaryPointGeographyOperator<LogicalVector, int> {
 public:
   S2BooleanOperation::Options options;
+  PointFastPath points;
 
   BinaryPredicateOperator(List s2options) {
     GeographyOperationOptions options(s2options);
     this->options = options.booleanOperationOptions();
+    this->points = PointFastPath(this->options);
   }
 };
 
@@ -27,8 +33,19 @@ LogicalVector cpp_s2_intersects(List geog1, List geog2, List s2options) {
   class Op: public BinaryPredicateOperator {
   public:
     Op(List s2options): BinaryPredicateOperator(s2options) {}
-    int processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2, R_xlen_t i) {
-      return s2geography::s2_intersects(feature1->Index(), feature2->Index(), options);
+    int processFeature(const PointFastPath::Feature& feature1,
+                       const PointFastPath::Feature& feature2, R_xlen_t i) {
+      bool result;
+      if (points.Intersects(feature1, feature2, &result)) {
+        return result;
+      }
+
+      std::unique_ptr<RGeography> scratch1, scratch2;
+      return s2geography::s2_intersects(
+        geography(feature1, &scratch1)->Index(),
+        geography(feature2, &scratch2)->Index(),
+        options
+      );
     };
   };
 
@@ -42,8 +59,19 @@ LogicalVector cpp_s2_equals(List geog1, List geog2, List s2options) {
   class Op: public BinaryPredicateOperator {
   public:
     Op(List s2options): BinaryPredicateOperator(s2options) {}
-    int processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2, R_xlen_t i) {
-      return s2geography::s2_equals(feature1->Index(), feature2->Index(), options);
+    int processFeature(const PointFastPath::Feature& feature1,
+                       const PointFastPath::Feature& feature2, R_xlen_t i) {
+      bool result;
+      if (points.Equals(feature1, feature2, &result)) {
+        return result;
+      }
+
+      std::unique_ptr<RGeography> scratch1, scratch2;
+      return s2geography::s2_equals(
+        geography(feature1, &scratch1)->Index(),
+        geography(feature2, &scratch2)->Index(),
+        options
+      );
     }
   };
 
@@ -56,8 +84,19 @@ LogicalVector cpp_s2_contains(List geog1, List geog2, List s2options) {
   class Op: public BinaryPredicateOperator {
   public:
     Op(List s2options): BinaryPredicateOperator(s2options) {}
-    int processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2, R_xlen_t i) {
-      return s2geography::s2_contains(feature1->Index(), feature2->Index(), options);
+    int processFeature(const PointFastPath::Feature& feature1,
+                       const PointFastPath::Feature& feature2, R_xlen_t i) {
+      bool result;
+      if (points.Contains(feature1, feature2, &result)) {
+        return result;
+      }
+
+      std::unique_ptr<RGeography> scratch1, scratch2;
+      return s2geography::s2_contains(
+        geography(feature1, &scratch1)->Index(),
+        geography(feature2, &scratch2)->Index(),
+        options
+      );
     }
   };
 
@@ -77,16 +116,63 @@ LogicalVector cpp_s2_touches(List geog1, List geog2, List s2options) {
       this->openOptions = this->options;
       this->openOptions.set_polygon_model(S2BooleanOperation::PolygonModel::OPEN);
       this->openOptions.set_polyline_model(S2BooleanOperation::PolylineModel::OPEN);
+
+      this->closedPoints = PointFastPath(this->closedOptions);
+      this->openPoints = PointFastPath(this->openOptions);
     }
 
-    int processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2, R_xlen_t i) {
-      return s2geography::s2_intersects(feature1->Index(), feature2->Index(), this->closedOptions) &&
-        !s2geography::s2_intersects(feature1->Index(), feature2->Index(), this->openOptions);
+    int processFeature(const PointFastPath::Feature& feature1,
+                       const PointFastPath::Feature& feature2, R_xlen_t i) {
+      bool closedResult, openResult;
+      if (closedPoints.Intersects(feature1, feature2, &closedResult) &&
+          openPoints.Intersects(feature1, feature2, &openResult)) {
+        return closedResult && !openResult;
+      }
+
+      std::unique_ptr<RGeography> scratch1, scratch2;
+      return s2geography::s2_relate(
+        geography(feature1, &scratch1)->Index(),
+        geography(feature2, &scratch2)->Index(),
+        options,
+        s2geography::RELATE_TOUCHES
+      ) != 0;
     }
 
   private:
     S2BooleanOperation::Options closedOptions;
     S2BooleanOperation::Options openOptions;
+    PointFastPath closedPoints;
+    PointFastPath openPoints;
+  };
+
+  Op op(s2options);
+  return op.processVector(geog1, geog2);
+}
+
+// Relation codes are computed by s2geography::s2_relate() as a combination
+// of the bits 1 (intersects), 2 (touches), 4 (contains), 8 (within),
+// 16 (covers), 32 (covered_by), and 64 (equals)
+// [[Rcpp::export]]
+IntegerVector cpp_s2_relate(List geog1, List geog2, List s2options) {
+  class Op: public BinaryPointGeographyOperator<IntegerVector, int> {
+  public:
+    Op(List s2options) {
+      GeographyOperationOptions options(s2options);
+      this->options = options.booleanOperationOptions();
+    }
+
+    int processFeature(const PointFastPath::Feature& feature1,
+                       const PointFastPath::Feature& feature2, R_xlen_t i) {
+      std::unique_ptr<RGeography> scratch1, scratch2;
+      return s2geography::s2_relate(
+        geography(feature1, &scratch1)->Index(),
+        geography(feature2, &scratch2)->Index(),
+        options
+      );
+    }
+
+  private:
+    S2BooleanOperation::Options options;
   };
 
   Op op(s2options);
@@ -95,25 +181,35 @@ LogicalVector cpp_s2_touches(List geog1, List geog2, List s2options) {
 
 // [[Rcpp::export]]
 LogicalVector cpp_s2_dwithin(List geog1, List geog2, NumericVector distance) {
-  if (distance.size() != geog1.size())  {
+  if (distance.size() != PointVector::Length(geog1))  {
     stop("Incompatible lengths"); // #nocov
   }
 
-  class Op: public BinaryGeographyOperator<LogicalVector, int> {
+  class Op: public BinaryPointGeographyOperator<LogicalVector, int> {
   public:
     NumericVector distance;
     RGeography* geog2_id;
     std::unique_ptr<S2ClosestEdgeQuery> query;
+    PointFastPath points;
 
     Op(NumericVector distance): distance(distance), geog2_id(nullptr) {}
 
-    int processFeature(XPtr<RGeography> feature1, XPtr<RGeography> feature2, R_xlen_t i) {
-      if (feature2.get() != geog2_id) {
-        this->query = absl::make_unique<S2ClosestEdgeQuery>(&feature2->Index().ShapeIndex());
-        this->geog2_id = feature2.get();
+    int processFeature(const PointFastPath::Feature& feature1,
+                       const PointFastPath::Feature& feature2, R_xlen_t i) {
+      bool result;
+      if (points.IsDistanceLessOrEqual(feature1, feature2,
+                                       S1ChordAngle::Radians(this->distance[i]),
+                                       &result)) {
+        return result;
+      }
+
+      // neither feature is a point, so both have a geography
+      if (feature2.geog != geog2_id) {
+        this->query = absl::make_unique<S2ClosestEdgeQuery>(&feature2.geog->Index().ShapeIndex());
+        this->geog2_id = feature2.geog;
       }
 
-      S2ClosestEdgeQuery::ShapeIndexTarget target(&feature1->Index().ShapeIndex());
+      S2ClosestEdgeQuery::ShapeIndexTarget target(&feature1.geog->Index().ShapeIndex());
       return query->IsDistanceLessOrEqual(&target, S1ChordAngle::Radians(this->distance[i]));
     }
   };
@@ -0,0 +1,126 @@
+
+#include "s2/util/coding/coder.h"
+#include "s2/util/coding/varint.h"
+
+#include "s2geography/encoding.h"
+
+#include "geography.h"
+#include "s2-parallel.h"
+
+#include <Rcpp.h>
+using namespace Rcpp;
+
+// Geography vectors are serialized as a single raw vector containing a
+// version byte, the number of features, and for each feature the size of
+// its encoding plus one (or zero for a missing feature) followed by the
+// output of s2geography::EncodeGeography(). The sizes let the decoder find
+// the start of each feature such that features can be encoded and decoded
+// in parallel.
+static const uint8_t kSerializeVersion = 1;
+
+// [[Rcpp::export]]
+RawVector cpp_s2_geography_encode(List geog, int numThreads) {
+  std::vector<RGeography*> features(geog.size(), nullptr);
+  for (R_xlen_t i = 0; i < geog.size(); i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features[i] = feature.get();
+    }
+  }
+
+  std::vector<Encoder> encoders(features.size());
+  try {
+    s2_parallel_for(
+      features.size(), numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] != nullptr) {
+            s2geography::EncodeGeography(features[i]->Geog(), &encoders[i]);
+          }
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  size_t size = 1 + Varint::Length64(features.size());
+  for (size_t i = 0; i < features.size(); i++) {
+    size_t feature_size = features[i] == nullptr ? 0 : encoders[i].length() + 1;
+    size += Varint::Length64(feature_size) + encoders[i].length();
+  }
+
+  RawVector out(size);
+  Encoder encoder(RAW(out), size);
+  encoder.put8(kSerializeVersion);
+  encoder.put_varint64(features.size());
+  for (size_t i = 0; i < features.size(); i++) {
+    if (features[i] == nullptr) {
+      encoder.put_varint64(0);
+    } else {
+      encoder.put_varint64(encoders[i].length() + 1);
+      encoder.putn(encoders[i].base(), encoders[i].length());
+    }
+  }
+
+  return out;
+}
+
+// [[Rcpp::export]]
+List cpp_s2_geography_decode(RawVector encoded, int numThreads) {
+  Decoder decoder(RAW(encoded), encoded.size());
+  uint64 n;
+  if (decoder.avail() < 1 || decoder.get8() != kSerializeVersion ||
+      !decoder.get_varint64(&n) || n > decoder.avail()) {
+    stop("Can't decode serialized s2_geography: unknown version or corrupt header");
+  }
+
+  // find the start and size of each feature
+  std::vector<const char*> starts(n, nullptr);
+  std::vector<size_t> sizes(n, 0);
+  for (uint64 i = 0; i < n; i++) {
+    uint64 feature_size;
+    if (!decoder.get_varint64(&feature_size) || feature_size > (decoder.avail() + 1)) {
+      stop("Can't decode serialized s2_geography: corrupt feature [i = %d]", (int) i + 1);
+    }
+
+    if (feature_size == 0) {
+      continue;
+    }
+
+    starts[i] = decoder.skip(0);
+    sizes[i] = feature_size - 1;
+    decoder.skip(sizes[i]);
+  }
+
+  std::vector<std::unique_ptr<s2geography::Geography>> features(n);
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (starts[i] == nullptr) {
+            continue;
+          }
+
+          Decoder feature_decoder(starts[i], sizes[i]);
+          features[i] = s2geography::DecodeGeography(&feature_decoder);
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  List out(features.size());
+  for (R_xlen_t i = 0; i < out.size(); i++) {
+    if (features[i]) {
+      out[i] = RGeography::MakeXPtr(std::move(features[i]));
+    } else {
+      out[i] = R_NilValue;
+    }
+  }
+
+  return out;
+}
@@ -4,6 +4,7 @@
 
 #include "s2-options.h"
 #include "geography-operator.h"
+#include "s2-parallel.h"
 
 #include <Rcpp.h>
 using namespace Rcpp;
@@ -55,6 +56,16 @@ List cpp_s2_sym_difference(List geog1, List geog2, List s2options) {
   return op.processVector(geog1, geog2);
 }
 
+// [[Rcpp::export]]
+double cpp_s2_max_memory_usage() {
+  std::shared_ptr<s2geography::MemoryBudget> budget = s2_last_memory_budget();
+  if (budget) {
+    return budget->max_usage_bytes();
+  } else {
+    return NA_REAL;
+  }
+}
+
 // [[Rcpp::export]]
 List cpp_s2_coverage_union_agg(List geog, List s2options, bool naRm) {
   GeographyOperationOptions options(s2options);
@@ -78,9 +89,22 @@ List cpp_s2_coverage_union_agg(List geog, List s2options, bool naRm) {
 }
 
 // [[Rcpp::export]]
-List cpp_s2_union_agg(List geog, List s2options, bool naRm) {
+List cpp_s2_union_agg(List geog, List s2options, bool naRm, int numThreads) {
   GeographyOperationOptions options(s2options);
   s2geography::S2UnionAggregator agg(options.geographyOptions());
+  agg.set_parallel_for(
+    [numThreads](int64_t n, const std::function<void(int64_t)>& func) {
+      s2_parallel_for(
+        n, numThreads,
+        [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+          for (R_xlen_t i = begin; i < end; i++) {
+            func(i);
+          }
+        },
+        1
+      );
+    }
+  );
 
   SEXP item;
   for (R_xlen_t i = 0; i < geog.size(); i++) {
@@ -95,7 +119,13 @@ List cpp_s2_union_agg(List geog, List s2options, bool naRm) {
     }
   }
 
-  std::unique_ptr<s2geography::Geography> geog_out = agg.Finalize();
+  std::unique_ptr<s2geography::Geography> geog_out;
+  try {
+    geog_out = agg.Finalize();
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
   return List::create(RGeography::MakeXPtr(std::move(geog_out)));
 }
 
@@ -376,6 +406,80 @@ List cpp_s2_buffer_cells(List geog, NumericVector distance, IntegerVector maxCel
   return op.processVector(geog);
 }
 
+// Features are buffered independently, so chunks of features are buffered
+// in parallel. A missing distance or error gives a missing result.
+// [[Rcpp::export]]
+List cpp_s2_buffer(List geog, NumericVector distance, NumericVector maxError,
+                   int endCapStyle, int polylineSide, int numThreads) {
+  R_xlen_t n = geog.size();
+  // workers can't touch the R API, so copy the arguments they need first
+  std::vector<double> distances(distance.begin(), distance.end());
+  std::vector<double> maxErrors(maxError.begin(), maxError.end());
+  std::vector<RGeography*> features(n, nullptr);
+  for (R_xlen_t i = 0; i < n; i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue && !std::isnan(distances[i]) && !std::isnan(maxErrors[i])) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features[i] = feature.get();
+    }
+  }
+
+  S2BufferOperation::Options baseOptions;
+  baseOptions.set_end_cap_style(
+    static_cast<S2BufferOperation::EndCapStyle>(endCapStyle)
+  );
+  baseOptions.set_polyline_side(
+    static_cast<S2BufferOperation::PolylineSide>(polylineSide)
+  );
+
+  std::vector<std::unique_ptr<s2geography::Geography>> results(n);
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        S2BufferOperation::Options options(baseOptions);
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] == nullptr) {
+            continue;
+          }
+
+          // the tolerance is specified as an absolute distance but
+          // S2BufferOperation uses a fraction of the buffer radius
+          options.set_buffer_radius(S1Angle::Radians(distances[i]));
+          if (distances[i] != 0) {
+            double fraction = std::abs(maxErrors[i] / distances[i]);
+            fraction = std::max(fraction, S2BufferOperation::Options::kMinErrorFraction);
+            fraction = std::min(fraction, 1.0);
+            options.set_error_fraction(fraction);
+          }
+
+          try {
+            results[i] = s2geography::s2_buffer(features[i]->Geog(), options);
+          } catch (s2geography::Exception& e) {
+            throw s2geography::Exception(
+              std::string(e.what()) + " [i = " + std::to_string(i + 1) + "]"
+            );
+          }
+        }
+      },
+      1
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  List output(n);
+  for (R_xlen_t i = 0; i < n; i++) {
+    if (results[i]) {
+      output[i] = RGeography::MakeXPtr(std::move(results[i]));
+    } else {
+      output[i] = R_NilValue;
+    }
+  }
+
+  return output;
+}
+
 // [[Rcpp::export]]
 List cpp_s2_convex_hull(List geog) {
   class Op: public UnaryGeographyOperator<List, SEXP> {
@@ -410,3 +514,132 @@ List cpp_s2_convex_hull_agg(List geog, bool naRm) {
 
   return List::create(RGeography::MakeXPtr(agg.Finalize()));
 }
+
+// Identifies the aggregate computed by cpp_s2_agg_by()
+enum class GroupedAggregate {
+  UNION = 1,
+  COVERAGE_UNION = 2,
+  CENTROID = 3,
+  CONVEX_HULL = 4,
+  REBUILD = 5
+};
+
+template <typename Aggregator>
+std::unique_ptr<s2geography::Geography> aggregateFeatures(
+    Aggregator& agg, const std::vector<RGeography*>& features) {
+  for (RGeography* feature : features) {
+    agg.Add(feature->Geog());
+  }
+
+  return agg.Finalize();
+}
+
+std::unique_ptr<s2geography::Geography> aggregateGroup(
+    GroupedAggregate type, const s2geography::GlobalOptions& options,
+    const std::vector<RGeography*>& features) {
+  switch (type) {
+  case GroupedAggregate::UNION: {
+    s2geography::S2UnionAggregator agg(options);
+    return aggregateFeatures(agg, features);
+  }
+  case GroupedAggregate::COVERAGE_UNION: {
+    s2geography::S2CoverageUnionAggregator agg(options);
+    return aggregateFeatures(agg, features);
+  }
+  case GroupedAggregate::CENTROID: {
+    s2geography::CentroidAggregator agg;
+    for (RGeography* feature : features) {
+      agg.Add(feature->Geog());
+    }
+
+    S2Point centroid = agg.Finalize();
+    if (centroid.Norm2() == 0) {
+      return absl::make_unique<s2geography::PointGeography>();
+    } else {
+      return absl::make_unique<s2geography::PointGeography>(centroid);
+    }
+  }
+  case GroupedAggregate::CONVEX_HULL: {
+    s2geography::S2ConvexHullAggregator agg;
+    return aggregateFeatures(agg, features);
+  }
+  case GroupedAggregate::REBUILD: {
+    s2geography::RebuildAggregator agg(options);
+    return aggregateFeatures(agg, features);
+  }
+  default:
+    throw s2geography::Exception("Unknown grouped aggregate");
+  }
+}
+
+// Computes one aggregate for each group in groupId (1-based, where
+// 1 <= groupId[i] <= nGroups) such that the result is aligned with the groups.
+// Features are sorted into groups on the main thread and groups are
+// aggregated using up to numThreads threads. Unions reuse one
+// S2UnionAggregator per thread (Finalize() resets it); other aggregates use
+// one aggregator per group.
+// [[Rcpp::export]]
+List cpp_s2_agg_by(List geog, IntegerVector groupId, int nGroups, int aggType,
+                   List s2options, bool naRm, int numThreads) {
+  GeographyOperationOptions options(s2options);
+  s2geography::GlobalOptions geographyOptions = options.geographyOptions();
+  GroupedAggregate type = static_cast<GroupedAggregate>(aggType);
+
+  std::vector<std::vector<RGeography*>> groups(nGroups);
+  std::vector<bool> hasNull(nGroups, false);
+
+  SEXP item;
+  for (R_xlen_t i = 0; i < geog.size(); i++) {
+    int group = groupId[i];
+    if (group == NA_INTEGER || group < 1 || group > nGroups) {
+      stop("Invalid group identifier [i = %d]", (int) i + 1);
+    }
+
+    item = geog[i];
+    if (item == R_NilValue) {
+      hasNull[group - 1] = true;
+    } else {
+      Rcpp::XPtr<RGeography> feature(item);
+      groups[group - 1].push_back(feature.get());
+    }
+  }
+
+  std::vector<std::unique_ptr<s2geography::S2UnionAggregator>> unionAggs;
+  for (int k = 0; k < std::max(numThreads, 1); k++) {
+    unionAggs.push_back(absl::make_unique<s2geography::S2UnionAggregator>(geographyOptions));
+  }
+
+  std::vector<std::unique_ptr<s2geography::Geography>> results(nGroups);
+  try {
+    s2_parallel_for(
+      nGroups, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (hasNull[i] && !naRm) {
+            continue;
+          }
+
+          if (type == GroupedAggregate::UNION) {
+            results[i] = aggregateFeatures(*unionAggs[worker_id], groups[i]);
+          } else {
+            results[i] = aggregateGroup(type, geographyOptions, groups[i]);
+          }
+        }
+      },
+      1
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  List output(nGroups);
+  for (R_xlen_t i = 0; i < nGroups; i++) {
+    if (results[i]) {
+      output[i] = RGeography::MakeXPtr(std::move(results[i]));
+    } else {
+      output[i] = R_NilValue;
+    }
+  }
+
+  return output;
+}
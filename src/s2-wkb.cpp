@@ -0,0 +1,204 @@
+
+#include "s2geography/wkb.h"
+
+#include "geography.h"
+#include "s2-parallel.h"
+
+#include <Rcpp.h>
+using namespace Rcpp;
+
+static S2::Projection* projectionFromXPtr(SEXP projection_xptr) {
+  if (projection_xptr == R_NilValue) {
+    return nullptr;
+  }
+
+  auto projection = reinterpret_cast<S2::Projection*>(R_ExternalPtrAddr(projection_xptr));
+  if (projection == nullptr) {
+    stop("External ptr to S2::Projection is not valid");
+  }
+
+  return projection;
+}
+
+// Unlike the wk handler (which must build features one at a time as wk reads
+// them), each feature is built independently from its own raw vector, so
+// chunks of features are read in parallel using one WKBReader per thread.
+// Problems are collected for every feature and reported together: invalid
+// WKB using stop_problems_wkb() and features that can't be constructed using
+// stop_problems_create().
+// [[Rcpp::export]]
+List cpp_s2_geog_from_wkb(List wkb, bool oriented, bool check, bool lax,
+                          SEXP projectionXPtr, double tessellateTolerance,
+                          int numThreads) {
+  s2geography::util::Constructor::Options options;
+  options.set_oriented(oriented);
+  options.set_check(check);
+  options.set_lax(lax);
+  options.set_projection(projectionFromXPtr(projectionXPtr));
+  if (tessellateTolerance != R_PosInf) {
+    options.set_tessellate_tolerance(S1Angle::Radians(tessellateTolerance));
+  }
+
+  R_xlen_t n = wkb.size();
+  std::vector<const uint8_t*> bytes(n, nullptr);
+  std::vector<int64_t> sizes(n, 0);
+  for (R_xlen_t i = 0; i < n; i++) {
+    SEXP item = wkb[i];
+    if (item != R_NilValue) {
+      if (TYPEOF(item) != RAWSXP) {
+        stop("Expected raw() or NULL for each feature [i = %d]", (int) i + 1);
+      }
+
+      bytes[i] = RAW(item);
+      sizes[i] = Rf_xlength(item);
+    }
+  }
+
+  int numReaders = std::max(numThreads, 1);
+  std::vector<std::unique_ptr<s2geography::WKBReader>> readers;
+  for (int i = 0; i < numReaders; i++) {
+    readers.push_back(absl::make_unique<s2geography::WKBReader>(options));
+  }
+
+  std::vector<std::unique_ptr<s2geography::Geography>> features(n);
+  std::vector<std::string> problems(n);
+  // not std::vector<bool>, which workers can't write to at the same time
+  std::vector<char> invalidWKB(n, false);
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (bytes[i] == nullptr) {
+            continue;
+          }
+
+          try {
+            features[i] = readers[worker_id]->ReadFeature(bytes[i], sizes[i]);
+          } catch (s2geography::WKBException& e) {
+            problems[i] = e.what();
+            invalidWKB[i] = true;
+            readers[worker_id] = absl::make_unique<s2geography::WKBReader>(options);
+          } catch (std::exception& e) {
+            problems[i] = e.what();
+            if (problems[i].empty()) {
+              problems[i] = "Unknown error";
+            }
+
+            // the reader may have been left in the middle of a feature
+            readers[worker_id] = absl::make_unique<s2geography::WKBReader>(options);
+          }
+        }
+      }
+    );
+  } catch (std::exception& e) {
+    stop(e.what());
+  }
+
+  // invalid WKB is reported first (it is an error even if check = FALSE)
+  for (bool wkbProblems: {true, false}) {
+    IntegerVector problemId;
+    CharacterVector problemMessage;
+    for (R_xlen_t i = 0; i < n; i++) {
+      if (!problems[i].empty() && static_cast<bool>(invalidWKB[i]) == wkbProblems) {
+        problemId.push_back(i);
+        problemMessage.push_back(problems[i]);
+      }
+    }
+
+    if (problemId.size() > 0) {
+      Environment s2NS = Environment::namespace_env("s2");
+      Function stopProblems =
+        s2NS[wkbProblems ? "stop_problems_wkb" : "stop_problems_create"];
+      stopProblems(problemId, problemMessage);
+    }
+  }
+
+  List output(n);
+  for (R_xlen_t i = 0; i < n; i++) {
+    if (features[i]) {
+      output[i] = RGeography::MakeXPtr(std::move(features[i]));
+    } else {
+      output[i] = R_NilValue;
+    }
+  }
+
+  return output;
+}
+
+// Features are written in two parallel passes: the first computes the exact
+// size of each feature so that every raw vector can be allocated once on the
+// main thread and the second writes the features into them.
+// [[Rcpp::export]]
+List cpp_s2_as_binary(List geog, SEXP projectionXPtr, int endian, int numThreads) {
+  s2geography::util::Constructor::Options options;
+  options.set_projection(projectionFromXPtr(projectionXPtr));
+  if (options.projection() == nullptr) {
+    stop("Can't write WKB without a projection");
+  }
+
+  R_xlen_t n = geog.size();
+  std::vector<RGeography*> features(n, nullptr);
+  for (R_xlen_t i = 0; i < n; i++) {
+    SEXP item = geog[i];
+    if (item != R_NilValue) {
+      Rcpp::XPtr<RGeography> feature(item);
+      features[i] = feature.get();
+    }
+  }
+
+  int numWriters = std::max(numThreads, 1);
+  std::vector<std::unique_ptr<s2geography::WKBWriter>> writers;
+  for (int i = 0; i < numWriters; i++) {
+    writers.push_back(absl::make_unique<s2geography::WKBWriter>(options, endian));
+  }
+
+  std::vector<int64_t> sizes(n, 0);
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] != nullptr) {
+            try {
+              sizes[i] = writers[worker_id]->SizeOf(features[i]->Geog());
+            } catch (s2geography::Exception& e) {
+              throw s2geography::Exception(
+                std::string(e.what()) + " [i = " + std::to_string(i + 1) + "]"
+              );
+            }
+          }
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  List output(n);
+  std::vector<uint8_t*> buffers(n, nullptr);
+  for (R_xlen_t i = 0; i < n; i++) {
+    if (features[i] != nullptr) {
+      SEXP item = Rf_allocVector(RAWSXP, sizes[i]);
+      output[i] = item;
+      buffers[i] = RAW(item);
+    }
+  }
+
+  try {
+    s2_parallel_for(
+      n, numThreads,
+      [&](int worker_id, R_xlen_t begin, R_xlen_t end) {
+        for (R_xlen_t i = begin; i < end; i++) {
+          if (features[i] != nullptr) {
+            writers[worker_id]->WriteFeature(features[i]->Geog(), buffers[i]);
+          }
+        }
+      }
+    );
+  } catch (s2geography::Exception& e) {
+    stop(e.what());
+  }
+
+  return output;
+}
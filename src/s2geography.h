@@ -9,5 +9,7 @@
 #include "s2geography/distance.h"
 #include "s2geography/geography.h"
 #include "s2geography/index.h"
+#include "s2geography/join.h"
 #include "s2geography/linear-referencing.h"
 #include "s2geography/predicates.h"
+#include "s2geography/relate.h"
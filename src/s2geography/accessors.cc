@@ -1,6 +1,8 @@
 
 #include "accessors.h"
 
+#include <s2/s2shape_measures.h>
+
 #include "build.h"
 #include "geography.h"
 
@@ -44,8 +46,11 @@ bool s2_is_collection(const Geography& geog) {
   }
 
   auto polygon_geog_ptr = dynamic_cast<const PolygonGeography*>(&geog);
+  auto lax_geog_ptr = dynamic_cast<const LaxPolygonGeography*>(&geog);
   if (polygon_geog_ptr != nullptr) {
     return s2_is_collection(*polygon_geog_ptr);
+  } else if (lax_geog_ptr != nullptr) {
+    return lax_geog_ptr->num_polygons() > 1;
   } else {
     std::unique_ptr<PolygonGeography> built = s2_build_polygon(geog);
     return s2_is_collection(*built);
@@ -101,6 +106,10 @@ double s2_area(const PolygonGeography& geog) {
   return geog.Polygon()->GetArea();
 }
 
+double s2_area(const LaxPolygonGeography& geog) {
+  return S2::GetArea(*geog.Polygon());
+}
+
 double s2_area(const GeographyCollection& geog) {
   double area = 0;
   for (auto& feature : geog.Features()) {
@@ -119,6 +128,11 @@ double s2_area(const Geography& geog) {
     return s2_area(*polygon_geog_ptr);
   }
 
+  auto lax_geog_ptr = dynamic_cast<const LaxPolygonGeography*>(&geog);
+  if (lax_geog_ptr != nullptr) {
+    return s2_area(*lax_geog_ptr);
+  }
+
   auto collection_geog_ptr = dynamic_cast<const GeographyCollection*>(&geog);
   if (collection_geog_ptr != nullptr) {
     return s2_area(*collection_geog_ptr);
@@ -13,6 +13,28 @@
 
 namespace s2geography {
 
+void MemoryBudget::Attach(S2MemoryTracker* tracker) const {
+  tracker->set_limit_bytes(limit_bytes_);
+  if (callback_) {
+    InterruptCallback callback = callback_;
+    tracker->set_periodic_callback(callback_alloc_delta_bytes_,
+                                   [tracker, callback]() {
+                                     if (callback()) {
+                                       tracker->SetError(S2Error::CANCELLED,
+                                                         "Operation cancelled");
+                                     }
+                                   });
+  }
+}
+
+void MemoryBudget::Record(const S2MemoryTracker& tracker) {
+  int64_t usage = tracker.max_usage_bytes();
+  int64_t current = max_usage_bytes_.load();
+  while (usage > current &&
+         !max_usage_bytes_.compare_exchange_weak(current, usage)) {
+  }
+}
+
 std::unique_ptr<Geography> s2_geography_from_layers(
     std::vector<S2Point> points,
     std::vector<std::unique_ptr<S2Polyline>> polylines,
@@ -109,16 +131,29 @@ std::unique_ptr<Geography> s2_boolean_operation(
   layers[2] = absl::make_unique<s2builderutil::S2PolygonLayer>(
       polygon.get(), options.polygon_layer);
 
+  // track memory usage if requested (the tracker must outlive the operation)
+  S2MemoryTracker tracker;
+  S2BooleanOperation::Options boolean_options = options.boolean_operation;
+  if (options.memory_budget) {
+    options.memory_budget->Attach(&tracker);
+    boolean_options.set_memory_tracker(&tracker);
+  }
+
   // specify the boolean operation
   S2BooleanOperation op(op_type,
                         // Normalizing the closed set here is required for line
                         // intersections to work in the same way as GEOS
                         s2builderutil::NormalizeClosedSet(std::move(layers)),
-                        options.boolean_operation);
+                        boolean_options);
 
   // do the boolean operation, build layers, and check for errors
   S2Error error;
-  if (!op.Build(geog1.ShapeIndex(), geog2.ShapeIndex(), &error)) {
+  bool built = op.Build(geog1.ShapeIndex(), geog2.ShapeIndex(), &error);
+  if (options.memory_budget) {
+    options.memory_budget->Record(tracker);
+  }
+
+  if (!built) {
     throw Exception(error.text());
   }
 
@@ -145,6 +180,12 @@ std::unique_ptr<PolygonGeography> s2_unary_union(const PolygonGeography& geog,
   layer_options.set_edge_type(S2Builder::EdgeType::UNDIRECTED);
   layer_options.set_validate(false);
 
+  S2MemoryTracker tracker;
+  if (options.memory_budget) {
+    options.memory_budget->Attach(&tracker);
+    builder_options.set_memory_tracker(&tracker);
+  }
+
   // Rebuild all loops as polygons using the S2Builder()
   std::vector<std::unique_ptr<S2Polygon>> loops;
   for (int i = 0; i < geog.Polygon()->num_loops(); i++) {
@@ -154,7 +195,12 @@ std::unique_ptr<PolygonGeography> s2_unary_union(const PolygonGeography& geog,
         loop.get(), layer_options));
     builder.AddShape(S2Loop::Shape(geog.Polygon()->loop(i)));
     S2Error error;
-    if (!builder.Build(&error)) {
+    bool built = builder.Build(&error);
+    if (options.memory_budget) {
+      options.memory_budget->Record(tracker);
+    }
+
+    if (!built) {
       throw Exception(error.text());
     }
 
@@ -230,8 +276,16 @@ std::unique_ptr<Geography> s2_rebuild(
     GlobalOptions::OutputAction point_layer_action,
     GlobalOptions::OutputAction polyline_layer_action,
     GlobalOptions::OutputAction polygon_layer_action) {
+  // track memory usage if requested (the tracker must outlive the builder)
+  S2MemoryTracker tracker;
+  S2Builder::Options builder_options = options.builder;
+  if (options.memory_budget) {
+    options.memory_budget->Attach(&tracker);
+    builder_options.set_memory_tracker(&tracker);
+  }
+
   // create the builder
-  S2Builder builder(options.builder);
+  S2Builder builder(builder_options);
 
   // create the data structures that will contain the output
   std::vector<S2Point> points;
@@ -268,7 +322,12 @@ std::unique_ptr<Geography> s2_rebuild(
 
   // build the output
   S2Error error;
-  if (!builder.Build(&error)) {
+  bool built = builder.Build(&error);
+  if (options.memory_budget) {
+    options.memory_budget->Record(tracker);
+  }
+
+  if (!built) {
     throw Exception(error.text());
   }
 
@@ -286,6 +345,35 @@ std::unique_ptr<Geography> s2_rebuild(const Geography& geog,
                     options.polygon_layer_action);
 }
 
+std::unique_ptr<PolygonGeography> s2_buffer(
+    const Geography& geog, const S2BufferOperation::Options& options) {
+  auto polygon = absl::make_unique<S2Polygon>();
+  S2BufferOperation op(
+      absl::make_unique<s2builderutil::S2PolygonLayer>(polygon.get()),
+      options);
+
+  if (options.buffer_radius() < S1Angle::Zero()) {
+    // only one input layer is allowed for a negative radius
+    MutableS2ShapeIndex index;
+    for (int i = 0; i < geog.num_shapes(); i++) {
+      index.Add(geog.Shape(i));
+    }
+
+    op.AddShapeIndex(index);
+  } else {
+    for (int i = 0; i < geog.num_shapes(); i++) {
+      op.AddShape(*geog.Shape(i));
+    }
+  }
+
+  S2Error error;
+  if (!op.Build(&error)) {
+    throw Exception(error.text());
+  }
+
+  return absl::make_unique<PolygonGeography>(std::move(polygon));
+}
+
 std::unique_ptr<PointGeography> s2_build_point(const Geography& geog) {
   std::unique_ptr<Geography> geog_out = s2_rebuild(
       geog, GlobalOptions(), GlobalOptions::OutputAction::OUTPUT_ACTION_INCLUDE,
@@ -344,27 +432,39 @@ std::unique_ptr<Geography> S2CoverageUnionAggregator::Finalize() {
                               S2BooleanOperation::OpType::UNION, options_);
 }
 
+S2UnionAggregator::S2UnionAggregator(const GlobalOptions& options)
+    : options_(options), root_(absl::make_unique<Node>()) {
+  parallel_for_ = [](int64_t n, const std::function<void(int64_t)>& func) {
+    for (int64_t i = 0; i < n; i++) {
+      func(i);
+    }
+  };
+}
+
 void S2UnionAggregator::Add(const Geography& geog) {
   if (geog.dimension() == 0 || geog.dimension() == 1) {
-    root_.index1.Add(geog);
-    return;
-  }
-
-  if (other_.empty()) {
-    other_.push_back(absl::make_unique<Node>());
-    other_.back()->index1.Add(geog);
+    root_->index1.Add(geog);
     return;
   }
 
-  Node* last = other_.back().get();
-  if (last->index1.num_shapes() == 0) {
-    last->index1.Add(geog);
-  } else if (last->index2.num_shapes() == 0) {
-    last->index2.Add(geog);
+  // The centre of the bounding rectangle is used for polygons (which is
+  // cheap because it is cached); otherwise, the first vertex is used. Empty
+  // features sort last.
+  S2CellId cell_id = S2CellId::Sentinel();
+  auto polygon = dynamic_cast<const PolygonGeography*>(&geog);
+  if (polygon != nullptr && !polygon->Polygon()->is_empty()) {
+    cell_id = S2CellId(polygon->Polygon()->GetRectBound().GetCenter());
   } else {
-    other_.push_back(absl::make_unique<Node>());
-    other_.back()->index1.Add(geog);
+    for (int i = 0; i < geog.num_shapes(); i++) {
+      std::unique_ptr<S2Shape> shape = geog.Shape(i);
+      if (shape->num_edges() > 0) {
+        cell_id = S2CellId(shape->edge(0).v0);
+        break;
+      }
+    }
   }
+
+  polygons_.emplace_back(cell_id, &geog);
 }
 
 std::unique_ptr<Geography> S2UnionAggregator::Node::Merge(
@@ -374,38 +474,59 @@ std::unique_ptr<Geography> S2UnionAggregator::Node::Merge(
 }
 
 std::unique_ptr<Geography> S2UnionAggregator::Finalize() {
-  for (int j = 0; j < 100; j++) {
-    if (other_.size() <= 1) {
-      break;
-    }
-
-    for (int64_t i = static_cast<int64_t>(other_.size()) - 1; i >= 1;
-         i = i - 2) {
-      // merge other_[i] with other_[i - 1]
-      std::unique_ptr<Geography> merged = other_[i]->Merge(options_);
-      std::unique_ptr<Geography> merged_prev = other_[i - 1]->Merge(options_);
-
-      // erase the last two nodes
-      other_.erase(other_.begin() + i - 1, other_.begin() + i + 1);
+  std::stable_sort(polygons_.begin(), polygons_.end(),
+                   [](const std::pair<S2CellId, const Geography*>& a,
+                      const std::pair<S2CellId, const Geography*>& b) {
+                     return a.first < b.first;
+                   });
+
+  std::vector<const Geography*> level;
+  level.reserve(polygons_.size());
+  for (const auto& item : polygons_) {
+    level.push_back(item.second);
+  }
 
-      // ..and replace it with a single node
-      other_.push_back(absl::make_unique<Node>());
-      other_.back()->index1.Add(*merged);
-      other_.back()->index2.Add(*merged_prev);
+  // Owners of the intermediate results (aligned with level), which are null
+  // for features owned by the caller
+  std::vector<std::unique_ptr<Geography>> owned(level.size());
+
+  while (level.size() > 1) {
+    int64_t num_pairs = level.size() / 2;
+    std::vector<std::unique_ptr<Geography>> merged(num_pairs);
+    parallel_for_(num_pairs, [&](int64_t i) {
+      ShapeIndexGeography index1(*level[2 * i]);
+      ShapeIndexGeography index2(*level[2 * i + 1]);
+      merged[i] = s2_boolean_operation(
+          index1, index2, S2BooleanOperation::OpType::UNION, options_);
+    });
+
+    std::vector<const Geography*> next;
+    next.reserve(num_pairs + 1);
+    for (const auto& geog : merged) {
+      next.push_back(geog.get());
+    }
 
-      // making sure to keep the underlying data alive
-      other_.back()->data.push_back(std::move(merged));
-      other_.back()->data.push_back(std::move(merged_prev));
+    // With an odd number of inputs, the last one is carried to the next level
+    if ((level.size() % 2) == 1) {
+      next.push_back(level.back());
+      merged.push_back(std::move(owned.back()));
     }
+
+    owned = std::move(merged);
+    level = std::move(next);
   }
 
-  if (other_.empty()) {
-    return root_.Merge(options_);
-  } else {
-    std::unique_ptr<Geography> merged = other_[0]->Merge(options_);
-    root_.index2.Add(*merged);
-    return root_.Merge(options_);
+  if (!level.empty()) {
+    root_->index2.Add(*level[0]);
   }
+
+  std::unique_ptr<Geography> result = root_->Merge(options_);
+
+  // The indexes refer to the inputs, so they are reset before the inputs
+  // that are owned here are deleted
+  root_ = absl::make_unique<Node>();
+  polygons_.clear();
+  return result;
 }
 
 }  // namespace s2geography
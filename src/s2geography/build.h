@@ -1,15 +1,64 @@
 
 #pragma once
 
+#include <s2/s2buffer_operation.h>
 #include <s2/s2builderutil_s2point_vector_layer.h>
 #include <s2/s2builderutil_s2polygon_layer.h>
 #include <s2/s2builderutil_s2polyline_vector_layer.h>
+#include <s2/s2memory_tracker.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
 
 #include "aggregator.h"
 #include "geography.h"
 
 namespace s2geography {
 
+// Limits and monitors the memory used by operations that use S2Builder
+// (s2_boolean_operation(), s2_unary_union(), s2_rebuild(), and the
+// aggregators that use them). Each operation gets its own S2MemoryTracker
+// whose limit is limit_bytes(); the same MemoryBudget may be shared by
+// operations running on more than one thread.
+class MemoryBudget {
+ public:
+  // Returns true if the current operation should be cancelled. This must be
+  // safe to call from any thread that runs an operation.
+  using InterruptCallback = std::function<bool()>;
+
+  explicit MemoryBudget(int64_t limit_bytes = S2MemoryTracker::kNoLimit)
+      : limit_bytes_(limit_bytes),
+        callback_alloc_delta_bytes_(0),
+        max_usage_bytes_(0) {}
+
+  int64_t limit_bytes() const { return limit_bytes_; }
+
+  // Calls callback after every callback_alloc_delta_bytes of allocation (and
+  // periodically during calculations that might take a long time) and
+  // cancels the operation if it returns true.
+  void set_interrupt_callback(int64_t callback_alloc_delta_bytes,
+                              InterruptCallback callback) {
+    callback_alloc_delta_bytes_ = callback_alloc_delta_bytes;
+    callback_ = std::move(callback);
+  }
+
+  // The largest memory usage of a single operation tracked by this budget.
+  int64_t max_usage_bytes() const { return max_usage_bytes_.load(); }
+
+  // Applies the limit and callback to the tracker for a single operation.
+  void Attach(S2MemoryTracker* tracker) const;
+
+  // Records the maximum usage of the tracker after its operation completes.
+  void Record(const S2MemoryTracker& tracker);
+
+ private:
+  int64_t limit_bytes_;
+  int64_t callback_alloc_delta_bytes_;
+  InterruptCallback callback_;
+  std::atomic<int64_t> max_usage_bytes_;
+};
+
 class GlobalOptions {
  public:
   enum OutputAction {
@@ -32,6 +81,9 @@ class GlobalOptions {
   OutputAction point_layer_action;
   OutputAction polyline_layer_action;
   OutputAction polygon_layer_action;
+
+  // If set, limits and monitors the memory used by each operation
+  std::shared_ptr<MemoryBudget> memory_budget;
 };
 
 std::unique_ptr<Geography> s2_boolean_operation(
@@ -44,6 +96,14 @@ std::unique_ptr<Geography> s2_unary_union(const ShapeIndexGeography& geog,
 std::unique_ptr<Geography> s2_rebuild(const Geography& geog,
                                         const GlobalOptions& options);
 
+// Returns the polygon containing all points within options.buffer_radius()
+// of geog using S2BufferOperation. With a positive radius, each shape is
+// buffered separately and the results are unioned, so geog may contain
+// overlapping shapes; with a negative radius (which only applies to
+// polygons), the polygons in geog must have disjoint interiors.
+std::unique_ptr<PolygonGeography> s2_buffer(
+    const Geography& geog, const S2BufferOperation::Options& options);
+
 std::unique_ptr<PointGeography> s2_build_point(const Geography& geog);
 
 std::unique_ptr<PolylineGeography> s2_build_polyline(const Geography& geog);
@@ -74,24 +134,42 @@ class S2CoverageUnionAggregator
   ShapeIndexGeography index_;
 };
 
+// Computes the union of all added features. Points and polylines are
+// unioned in a single operation at the end; polygons are unioned pairwise
+// in a tree whose leaves are sorted by the S2CellId of a representative point
+// such that nearby polygons are merged first and intermediate results stay
+// small. The unions at each level of the tree are independent and are
+// evaluated using the function set with set_parallel_for() (by default, in
+// order on the calling thread). Finalize() resets the aggregator such that
+// it can be reused for another set of features.
+//
+// Features must outlive the aggregator.
 class S2UnionAggregator : public Aggregator<std::unique_ptr<Geography>> {
  public:
-  S2UnionAggregator(const GlobalOptions& options) : options_(options) {}
+  // Calls func(i) for every i in [0, n), possibly from other threads.
+  using ParallelFor =
+      std::function<void(int64_t n, const std::function<void(int64_t)>& func)>;
+
+  S2UnionAggregator(const GlobalOptions& options);
   void Add(const Geography& geog);
   std::unique_ptr<Geography> Finalize();
 
+  void set_parallel_for(ParallelFor parallel_for) {
+    parallel_for_ = std::move(parallel_for);
+  }
+
  private:
   class Node {
    public:
     ShapeIndexGeography index1;
     ShapeIndexGeography index2;
-    std::vector<std::unique_ptr<Geography>> data;
     std::unique_ptr<Geography> Merge(const GlobalOptions& options);
   };
 
   GlobalOptions options_;
-  Node root_;
-  std::vector<std::unique_ptr<Node>> other_;
+  ParallelFor parallel_for_;
+  std::unique_ptr<Node> root_;
+  std::vector<std::pair<S2CellId, const Geography*>> polygons_;
 };
 
 }  // namespace s2geography
@@ -1,9 +1,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <sstream>
 
 #include <s2/s2edge_tessellator.h>
+#include <s2/s2loop_measures.h>
 
 #include "geoarrow-imports.h"
 #include "geography.h"
@@ -16,11 +18,16 @@ class Constructor : public Handler {
  public:
   class Options {
    public:
-    Options() : oriented_(false), check_(true), tessellate_tolerance_(S1Angle::Infinity()) {}
+    Options() : oriented_(false), check_(true), lax_(false), tessellate_tolerance_(S1Angle::Infinity()) {}
     bool oriented() const { return oriented_; }
     void set_oriented(bool oriented) { oriented_ = oriented; }
     bool check() const { return check_; }
     void set_check(bool check) { check_ = check; }
+    // When lax is true, polylines and polygons are built as
+    // LaxPolylineGeography and LaxPolygonGeography objects, which skips
+    // building S2Polyline and S2Polygon objects (and validating them).
+    bool lax() const { return lax_; }
+    void set_lax(bool lax) { lax_ = lax; }
     S2::Projection* projection() const { return projection_; }
     void set_projection(S2::Projection* projection) { projection_ = projection; }
     S1Angle tessellate_tolerance() const { return tessellate_tolerance_; }
@@ -31,6 +38,7 @@ class Constructor : public Handler {
    private:
     bool oriented_;
     bool check_;
+    bool lax_;
     S2::Projection* projection_;
     S1Angle tessellate_tolerance_;
   };
@@ -178,7 +186,10 @@ class PolylineConstructor : public Constructor {
   Result geom_end() {
     finish_points();
 
-    if (!points_.empty()) {
+    if (!points_.empty() && options_.lax()) {
+      lax_polylines_.push_back(absl::make_unique<S2LaxPolylineShape>(points_));
+      points_.clear();
+    } else if (!points_.empty()) {
       auto polyline = absl::make_unique<S2Polyline>();
       polyline->Init(std::move(points_));
 
@@ -197,6 +208,13 @@ class PolylineConstructor : public Constructor {
   }
 
   std::unique_ptr<Geography> finish() {
+    if (options_.lax()) {
+      auto result =
+          absl::make_unique<LaxPolylineGeography>(std::move(lax_polylines_));
+      lax_polylines_.clear();
+      return std::unique_ptr<Geography>(result.release());
+    }
+
     std::unique_ptr<PolylineGeography> result;
 
     if (polylines_.empty()) {
@@ -211,12 +229,22 @@ class PolylineConstructor : public Constructor {
 
  private:
   std::vector<std::unique_ptr<S2Polyline>> polylines_;
+  std::vector<std::unique_ptr<S2LaxPolylineShape>> lax_polylines_;
   S2Error error_;
 };
 
 class PolygonConstructor : public Constructor {
  public:
-  PolygonConstructor(const Options& options) : Constructor(options) {}
+  PolygonConstructor(const Options& options)
+      : Constructor(options), num_polygon_loops_(0) {}
+
+  Result geom_start(util::GeometryType geometry_type, int64_t size) {
+    if (geometry_type == util::GeometryType::POLYGON) {
+      num_polygon_loops_ = 0;
+    }
+
+    return Result::CONTINUE;
+  }
 
   Result ring_start(int64_t size) {
     input_points_.clear();
@@ -235,6 +263,12 @@ class PolygonConstructor : public Constructor {
     }
 
     points_.pop_back();
+
+    if (options_.lax()) {
+      finish_lax_loop();
+      return Result::CONTINUE;
+    }
+
     auto loop = absl::make_unique<S2Loop>();
     loop->set_s2debug_override(S2Debug::DISABLE);
     loop->Init(std::move(points_));
@@ -257,6 +291,16 @@ class PolygonConstructor : public Constructor {
   }
 
   std::unique_ptr<Geography> finish() {
+    if (options_.lax()) {
+      auto polygon = absl::make_unique<S2LaxPolygonShape>(lax_loops_);
+      lax_loop_offsets_.push_back(lax_loops_.size());
+      auto result = absl::make_unique<LaxPolygonGeography>(
+          std::move(polygon), std::move(lax_loop_offsets_));
+      lax_loops_.clear();
+      lax_loop_offsets_.clear();
+      return std::unique_ptr<Geography>(result.release());
+    }
+
     auto polygon = absl::make_unique<S2Polygon>();
     polygon->set_s2debug_override(S2Debug::DISABLE);
     if (options_.oriented()) {
@@ -278,7 +322,35 @@ class PolygonConstructor : public Constructor {
 
  private:
   std::vector<std::unique_ptr<S2Loop>> loops_;
+  std::vector<S2LaxPolygonShape::Loop> lax_loops_;
+  std::vector<int> lax_loop_offsets_;
+  int num_polygon_loops_;
   S2Error error_;
+
+  // The first loop of each polygon is its shell and any others are holes.
+  // Unless the input is oriented, loops are normalized like S2Loop::Normalize()
+  // (i.e., such that they cover at most half the sphere) and holes are then
+  // reversed so that the interior of the polygon is always on the left.
+  void finish_lax_loop() {
+    if (!options_.oriented()) {
+      bool reverse = !S2::IsNormalized(points_);
+      if (num_polygon_loops_ > 0) {
+        reverse = !reverse;
+      }
+
+      if (reverse) {
+        std::reverse(points_.begin(), points_.end());
+      }
+    }
+
+    if (num_polygon_loops_ == 0) {
+      lax_loop_offsets_.push_back(lax_loops_.size());
+    }
+
+    lax_loops_.push_back(std::move(points_));
+    points_.clear();
+    num_polygon_loops_++;
+  }
 };
 
 class CollectionConstructor : public Constructor {
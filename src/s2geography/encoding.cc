@@ -0,0 +1,185 @@
+
+#include "encoding.h"
+
+#include <s2/encoded_s2point_vector.h>
+
+namespace s2geography {
+
+namespace {
+
+// Identifies the Geography subclass of each encoded feature
+enum class EncodingTag : uint8_t {
+  POINT = 1,
+  POLYLINE = 2,
+  POLYGON = 3,
+  COLLECTION = 4,
+  LAX_POLYLINE = 5,
+  LAX_POLYGON = 6
+};
+
+}  // namespace
+
+void EncodeGeography(const Geography& geog, Encoder* encoder) {
+  if (auto points = dynamic_cast<const PointGeography*>(&geog)) {
+    encoder->Ensure(1);
+    encoder->put8(static_cast<uint8_t>(EncodingTag::POINT));
+    s2coding::EncodeS2PointVector(points->Points(),
+                                  s2coding::CodingHint::COMPACT, encoder);
+  } else if (auto polylines = dynamic_cast<const PolylineGeography*>(&geog)) {
+    encoder->Ensure(1 + Varint::kMax32);
+    encoder->put8(static_cast<uint8_t>(EncodingTag::POLYLINE));
+    encoder->put_varint32(polylines->Polylines().size());
+    for (const auto& polyline : polylines->Polylines()) {
+      polyline->Encode(encoder, s2coding::CodingHint::COMPACT);
+    }
+  } else if (auto polygon = dynamic_cast<const PolygonGeography*>(&geog)) {
+    encoder->Ensure(1);
+    encoder->put8(static_cast<uint8_t>(EncodingTag::POLYGON));
+    polygon->Polygon()->Encode(encoder, s2coding::CodingHint::COMPACT);
+  } else if (auto polylines = dynamic_cast<const LaxPolylineGeography*>(&geog)) {
+    encoder->Ensure(1 + Varint::kMax32);
+    encoder->put8(static_cast<uint8_t>(EncodingTag::LAX_POLYLINE));
+    encoder->put_varint32(polylines->Polylines().size());
+    for (const auto& polyline : polylines->Polylines()) {
+      polyline->Encode(encoder, s2coding::CodingHint::COMPACT);
+    }
+  } else if (auto polygon = dynamic_cast<const LaxPolygonGeography*>(&geog)) {
+    const std::vector<int>& offsets = polygon->LoopOffsets();
+    encoder->Ensure(1 + Varint::kMax32 * (1 + offsets.size()));
+    encoder->put8(static_cast<uint8_t>(EncodingTag::LAX_POLYGON));
+    encoder->put_varint32(offsets.size());
+    for (int offset : offsets) {
+      encoder->put_varint32(offset);
+    }
+    polygon->Polygon()->Encode(encoder, s2coding::CodingHint::COMPACT);
+  } else if (auto collection = dynamic_cast<const GeographyCollection*>(&geog)) {
+    encoder->Ensure(1 + Varint::kMax32);
+    encoder->put8(static_cast<uint8_t>(EncodingTag::COLLECTION));
+    encoder->put_varint32(collection->Features().size());
+    for (const auto& feature : collection->Features()) {
+      EncodeGeography(*feature, encoder);
+    }
+  } else {
+    throw Exception("Can't encode unsupported Geography subclass");
+  }
+}
+
+std::unique_ptr<Geography> DecodeGeography(Decoder* decoder) {
+  if (decoder->avail() < 1) {
+    throw Exception("Unexpected end of encoded geography");
+  }
+
+  uint8_t tag = decoder->get8();
+  uint32_t size;
+
+  switch (static_cast<EncodingTag>(tag)) {
+    case EncodingTag::POINT: {
+      s2coding::EncodedS2PointVector encoded;
+      if (!encoded.Init(decoder)) {
+        throw Exception("Failed to decode encoded points");
+      }
+
+      std::vector<S2Point> points(encoded.size());
+      for (size_t i = 0; i < points.size(); i++) {
+        points[i] = encoded[i];
+      }
+
+      return absl::make_unique<PointGeography>(std::move(points));
+    }
+
+    case EncodingTag::POLYLINE: {
+      if (!decoder->get_varint32(&size) || size > decoder->avail()) {
+        throw Exception("Failed to decode encoded polylines");
+      }
+
+      std::vector<std::unique_ptr<S2Polyline>> polylines;
+      polylines.reserve(size);
+      for (uint32_t i = 0; i < size; i++) {
+        auto polyline = absl::make_unique<S2Polyline>();
+        polyline->set_s2debug_override(S2Debug::DISABLE);
+        if (!polyline->Decode(decoder)) {
+          throw Exception("Failed to decode encoded polyline");
+        }
+
+        polylines.push_back(std::move(polyline));
+      }
+
+      return absl::make_unique<PolylineGeography>(std::move(polylines));
+    }
+
+    case EncodingTag::POLYGON: {
+      auto polygon = absl::make_unique<S2Polygon>();
+      polygon->set_s2debug_override(S2Debug::DISABLE);
+      if (!polygon->Decode(decoder)) {
+        throw Exception("Failed to decode encoded polygon");
+      }
+
+      return absl::make_unique<PolygonGeography>(std::move(polygon));
+    }
+
+    case EncodingTag::LAX_POLYLINE: {
+      if (!decoder->get_varint32(&size) || size > decoder->avail()) {
+        throw Exception("Failed to decode encoded polylines");
+      }
+
+      std::vector<std::unique_ptr<S2LaxPolylineShape>> polylines;
+      polylines.reserve(size);
+      for (uint32_t i = 0; i < size; i++) {
+        auto polyline = absl::make_unique<S2LaxPolylineShape>();
+        if (!polyline->Init(decoder)) {
+          throw Exception("Failed to decode encoded polyline");
+        }
+
+        polylines.push_back(std::move(polyline));
+      }
+
+      return absl::make_unique<LaxPolylineGeography>(std::move(polylines));
+    }
+
+    case EncodingTag::LAX_POLYGON: {
+      if (!decoder->get_varint32(&size) || size == 0 ||
+          size > decoder->avail()) {
+        throw Exception("Failed to decode encoded polygon");
+      }
+
+      std::vector<int> offsets(size);
+      uint32_t offset;
+      for (uint32_t i = 0; i < size; i++) {
+        if (!decoder->get_varint32(&offset)) {
+          throw Exception("Failed to decode encoded polygon");
+        }
+
+        offsets[i] = offset;
+      }
+
+      auto polygon = absl::make_unique<S2LaxPolygonShape>();
+      if (!polygon->Init(decoder) ||
+          offsets.back() != polygon->num_loops()) {
+        throw Exception("Failed to decode encoded polygon");
+      }
+
+      return absl::make_unique<LaxPolygonGeography>(std::move(polygon),
+                                                    std::move(offsets));
+    }
+
+    case EncodingTag::COLLECTION: {
+      if (!decoder->get_varint32(&size) || size > decoder->avail()) {
+        throw Exception("Failed to decode encoded collection");
+      }
+
+      std::vector<std::unique_ptr<Geography>> features;
+      features.reserve(size);
+      for (uint32_t i = 0; i < size; i++) {
+        features.push_back(DecodeGeography(decoder));
+      }
+
+      return absl::make_unique<GeographyCollection>(std::move(features));
+    }
+
+    default:
+      throw Exception("Unknown encoded geography type: " +
+                      std::to_string(tag));
+  }
+}
+
+}  // namespace s2geography
@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include <s2/util/coding/coder.h>
+
+#include <memory>
+
+#include "geography.h"
+
+namespace s2geography {
+
+// Appends a lossless binary representation of geog to encoder. Points are
+// written using s2coding::EncodeS2PointVector() and polylines and polygons
+// using their own Encode() methods, all of which use a compact encoding
+// for vertices that are snapped to S2Cell centers and exact doubles
+// otherwise. Polygon loops are written with their depth and orientation
+// such that decoding does not need to reassemble or normalize them. Lax
+// polylines and polygons are written using the Encode() methods of their
+// shapes (along with the loop offsets of each polygon) and are decoded as
+// lax geographies.
+//
+// REQUIRES: encoder uses the default constructor, so that its buffer can be
+//           enlarged as necessary.
+void EncodeGeography(const Geography& geog, Encoder* encoder);
+
+// Decodes a geography written by EncodeGeography() or throws Exception if
+// decoder does not contain a valid encoded geography. Decoded polygons are
+// not checked for validity.
+std::unique_ptr<Geography> DecodeGeography(Decoder* decoder);
+
+}  // namespace s2geography
@@ -0,0 +1,847 @@
+
+#include "geoarrow.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace s2geography {
+
+namespace geoarrow {
+
+namespace {
+
+const char* kExtensionNames[] = {
+    "geoarrow.wkb",             "geoarrow.point",
+    "geoarrow.linestring",      "geoarrow.polygon",
+    "geoarrow.multipoint",      "geoarrow.multilinestring",
+    "geoarrow.multipolygon"};
+
+// The number of nested list arrays between a feature and its coordinates
+int Nesting(util::GeometryType geometry_type) {
+  switch (geometry_type) {
+    case util::GeometryType::POINT:
+      return 0;
+    case util::GeometryType::LINESTRING:
+    case util::GeometryType::MULTIPOINT:
+      return 1;
+    case util::GeometryType::POLYGON:
+    case util::GeometryType::MULTILINESTRING:
+      return 2;
+    case util::GeometryType::MULTIPOLYGON:
+      return 3;
+    default:
+      throw Exception("Unsupported geometry type for GeoArrow");
+  }
+}
+
+int32_t ReadInt32(const char** ptr) {
+  int32_t value;
+  memcpy(&value, *ptr, sizeof(int32_t));
+  *ptr += sizeof(int32_t);
+  return value;
+}
+
+// Schema metadata is encoded as an int32 number of key/value pairs followed
+// by an int32 length and the bytes of each key and value.
+std::string ExtensionName(const char* metadata) {
+  if (metadata == nullptr) {
+    return "";
+  }
+
+  const char* ptr = metadata;
+  int32_t n = ReadInt32(&ptr);
+  for (int32_t i = 0; i < n; i++) {
+    int32_t key_size = ReadInt32(&ptr);
+    std::string key(ptr, key_size);
+    ptr += key_size;
+
+    int32_t value_size = ReadInt32(&ptr);
+    std::string value(ptr, value_size);
+    ptr += value_size;
+
+    if (key == "ARROW:extension:name") {
+      return value;
+    }
+  }
+
+  return "";
+}
+
+void AppendMetadataString(const std::string& value, std::string* out) {
+  int32_t size = static_cast<int32_t>(value.size());
+  out->append(reinterpret_cast<const char*>(&size), sizeof(int32_t));
+  out->append(value);
+}
+
+std::string ExtensionMetadata(util::GeometryType geometry_type) {
+  std::string out;
+  int32_t n = 2;
+  out.append(reinterpret_cast<const char*>(&n), sizeof(int32_t));
+  AppendMetadataString("ARROW:extension:name", &out);
+  AppendMetadataString(kExtensionNames[geometry_type], &out);
+  AppendMetadataString("ARROW:extension:metadata", &out);
+  AppendMetadataString("{\"edges\":\"spherical\"}", &out);
+  return out;
+}
+
+struct SchemaPrivate {
+  std::string format;
+  std::string name;
+  std::string metadata;
+  std::vector<struct ArrowSchema*> children;
+};
+
+void ReleaseSchema(struct ArrowSchema* schema) {
+  auto priv = reinterpret_cast<SchemaPrivate*>(schema->private_data);
+  for (struct ArrowSchema* child : priv->children) {
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+    delete child;
+  }
+
+  delete priv;
+  schema->release = nullptr;
+}
+
+// Initializes schema to own priv and its children
+void InitSchema(struct ArrowSchema* schema, SchemaPrivate* priv) {
+  schema->format = priv->format.c_str();
+  schema->name = priv->name.c_str();
+  schema->metadata = priv->metadata.empty() ? nullptr : priv->metadata.data();
+  schema->flags = ARROW_FLAG_NULLABLE;
+  schema->n_children = priv->children.size();
+  schema->children = priv->children.data();
+  schema->dictionary = nullptr;
+  schema->release = &ReleaseSchema;
+  schema->private_data = priv;
+}
+
+struct ArrowSchema* NewSchema(std::string format, std::string name) {
+  auto priv = new SchemaPrivate();
+  priv->format = std::move(format);
+  priv->name = std::move(name);
+  auto schema = new struct ArrowSchema;
+  InitSchema(schema, priv);
+  return schema;
+}
+
+struct ArrayPrivate {
+  std::vector<uint8_t> validity;
+  std::vector<int32_t> offsets;
+  std::vector<double> values;
+  std::vector<const void*> buffers;
+  std::vector<struct ArrowArray*> children;
+};
+
+void ReleaseArray(struct ArrowArray* array) {
+  auto priv = reinterpret_cast<ArrayPrivate*>(array->private_data);
+  for (struct ArrowArray* child : priv->children) {
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+    delete child;
+  }
+
+  delete priv;
+  array->release = nullptr;
+}
+
+// Initializes array to own priv and its children. The buffers must
+// already point to data owned by priv (or be nullptr).
+void InitArray(struct ArrowArray* array, int64_t length, int64_t null_count,
+               ArrayPrivate* priv) {
+  array->length = length;
+  array->null_count = null_count;
+  array->offset = 0;
+  array->n_buffers = priv->buffers.size();
+  array->buffers = priv->buffers.data();
+  array->n_children = priv->children.size();
+  array->children = priv->children.data();
+  array->dictionary = nullptr;
+  array->release = &ReleaseArray;
+  array->private_data = priv;
+}
+
+struct ArrowArray* NewDoubleArray(std::vector<double> values) {
+  auto priv = new ArrayPrivate();
+  priv->values = std::move(values);
+  priv->buffers = {nullptr, priv->values.data()};
+  auto array = new struct ArrowArray;
+  InitArray(array, priv->values.size(), 0, priv);
+  return array;
+}
+
+}  // namespace
+
+Reader::Reader(const util::Constructor::Options& options)
+    : options_(options),
+      constructor_(options),
+      geometry_type_(util::GeometryType::GEOMETRY_TYPE_UNKNOWN),
+      coord_type_(CoordType::SEPARATED),
+      coord_size_(2),
+      nesting_(0) {}
+
+void Reader::Init(const struct ArrowSchema* schema) {
+  std::string extension_name = ExtensionName(schema->metadata);
+  geometry_type_ = util::GeometryType::GEOMETRY_TYPE_UNKNOWN;
+  for (int i = util::GeometryType::POINT; i <= util::GeometryType::MULTIPOLYGON;
+       i++) {
+    if (extension_name == kExtensionNames[i]) {
+      geometry_type_ = static_cast<util::GeometryType>(i);
+    }
+  }
+
+  if (geometry_type_ == util::GeometryType::GEOMETRY_TYPE_UNKNOWN) {
+    throw Exception(
+        "Expected a geoarrow.point, geoarrow.linestring, geoarrow.polygon, "
+        "geoarrow.multipoint, geoarrow.multilinestring, or "
+        "geoarrow.multipolygon array but got extension name '" +
+        extension_name + "'");
+  }
+
+  nesting_ = Nesting(geometry_type_);
+  large_offsets_.clear();
+  const struct ArrowSchema* coord_schema = schema;
+  for (int level = 0; level < nesting_; level++) {
+    std::string format(coord_schema->format);
+    if (format == "+l") {
+      large_offsets_.push_back(false);
+    } else if (format == "+L") {
+      large_offsets_.push_back(true);
+    } else {
+      throw Exception("Expected list storage for " + extension_name +
+                      " but got format '" + format + "'");
+    }
+
+    coord_schema = coord_schema->children[0];
+  }
+
+  std::string format(coord_schema->format);
+  bool has_m = false;
+  if (format == "+s") {
+    coord_type_ = CoordType::SEPARATED;
+    coord_size_ = coord_schema->n_children;
+    for (int64_t i = 0; i < coord_schema->n_children; i++) {
+      const struct ArrowSchema* child = coord_schema->children[i];
+      if (std::string(child->format) != "g") {
+        throw Exception("Expected double coordinates but got format '" +
+                        std::string(child->format) + "'");
+      }
+
+      has_m = has_m || (child->name != nullptr && std::string(child->name) == "m");
+    }
+  } else if (format.size() > 3 && format.substr(0, 3) == "+w:") {
+    coord_type_ = CoordType::INTERLEAVED;
+    coord_size_ = std::atoi(format.c_str() + 3);
+    const struct ArrowSchema* child = coord_schema->children[0];
+    if (std::string(child->format) != "g") {
+      throw Exception("Expected double coordinates but got format '" +
+                      std::string(child->format) + "'");
+    }
+
+    has_m = child->name != nullptr && std::string(child->name).find('m') != std::string::npos;
+  } else {
+    throw Exception("Expected struct or fixed-size list coordinates but got format '" +
+                    format + "'");
+  }
+
+  if (coord_size_ < 2 || coord_size_ > 4) {
+    throw Exception("Expected coordinates with 2, 3, or 4 dimensions");
+  }
+
+  if (options_.projection() == nullptr && (coord_size_ != 3 || has_m)) {
+    throw Exception("Expected xyz coordinates when reading without a projection");
+  }
+
+  scratch_.clear();
+}
+
+std::unique_ptr<Geography> Reader::ReadFeature(const struct ArrowArray* array,
+                                               int64_t i) {
+  auto validity = reinterpret_cast<const uint8_t*>(array->buffers[0]);
+  if (array->null_count != 0 && validity != nullptr) {
+    int64_t bit = array->offset + i;
+    if (((validity[bit / 8] >> (bit % 8)) & 0x01) == 0) {
+      return nullptr;
+    }
+  }
+
+  constructor_.feat_start();
+  int64_t begin, end;
+
+  switch (geometry_type_) {
+    case util::GeometryType::POINT:
+      constructor_.geom_start(util::GeometryType::POINT, 1);
+      ReadCoords(array, i, i + 1);
+      constructor_.geom_end();
+      break;
+
+    case util::GeometryType::LINESTRING:
+    case util::GeometryType::MULTIPOINT:
+      // the child points of a multipoint can be passed to the
+      // constructor all at once
+      ReadLinestring(array, 0, i, geometry_type_);
+      break;
+
+    case util::GeometryType::POLYGON:
+      ReadPolygon(array, 0, i);
+      break;
+
+    case util::GeometryType::MULTILINESTRING:
+      Range(array, 0, i, &begin, &end);
+      constructor_.geom_start(util::GeometryType::MULTILINESTRING, end - begin);
+      for (int64_t j = begin; j < end; j++) {
+        ReadLinestring(array->children[0], 1, j,
+                       util::GeometryType::LINESTRING);
+      }
+      constructor_.geom_end();
+      break;
+
+    case util::GeometryType::MULTIPOLYGON:
+      Range(array, 0, i, &begin, &end);
+      constructor_.geom_start(util::GeometryType::MULTIPOLYGON, end - begin);
+      for (int64_t j = begin; j < end; j++) {
+        ReadPolygon(array->children[0], 1, j);
+      }
+      constructor_.geom_end();
+      break;
+
+    default:
+      throw Exception("Reader::Init() was not called");
+  }
+
+  return constructor_.finish_feature();
+}
+
+void Reader::ReadLinestring(const struct ArrowArray* array, int level,
+                            int64_t i, util::GeometryType geometry_type) {
+  int64_t begin, end;
+  Range(array, level, i, &begin, &end);
+  constructor_.geom_start(geometry_type, end - begin);
+  ReadCoords(array->children[0], begin, end);
+  constructor_.geom_end();
+}
+
+void Reader::ReadPolygon(const struct ArrowArray* array, int level,
+                         int64_t i) {
+  int64_t begin, end;
+  Range(array, level, i, &begin, &end);
+  constructor_.geom_start(util::GeometryType::POLYGON, end - begin);
+
+  const struct ArrowArray* rings = array->children[0];
+  for (int64_t j = begin; j < end; j++) {
+    int64_t ring_begin, ring_end;
+    Range(rings, level + 1, j, &ring_begin, &ring_end);
+    constructor_.ring_start(ring_end - ring_begin);
+    ReadCoords(rings->children[0], ring_begin, ring_end);
+    constructor_.ring_end();
+  }
+
+  constructor_.geom_end();
+}
+
+void Reader::Range(const struct ArrowArray* array, int level, int64_t i,
+                   int64_t* begin, int64_t* end) {
+  int64_t j = array->offset + i;
+  if (large_offsets_[level]) {
+    auto offsets = reinterpret_cast<const int64_t*>(array->buffers[1]);
+    *begin = offsets[j];
+    *end = offsets[j + 1];
+  } else {
+    auto offsets = reinterpret_cast<const int32_t*>(array->buffers[1]);
+    *begin = offsets[j];
+    *end = offsets[j + 1];
+  }
+}
+
+void Reader::ReadCoords(const struct ArrowArray* array, int64_t begin,
+                        int64_t end) {
+  int64_t n = end - begin;
+  if (n <= 0) {
+    return;
+  }
+
+  if (coord_type_ == CoordType::INTERLEAVED) {
+    const struct ArrowArray* values = array->children[0];
+    auto data = reinterpret_cast<const double*>(values->buffers[1]);
+    constructor_.coords(
+        data + values->offset + (array->offset + begin) * coord_size_, n,
+        coord_size_);
+    return;
+  }
+
+  scratch_.resize(n * coord_size_);
+  for (int32_t d = 0; d < coord_size_; d++) {
+    const struct ArrowArray* values = array->children[d];
+    auto data = reinterpret_cast<const double*>(values->buffers[1]) +
+                values->offset + array->offset + begin;
+    for (int64_t j = 0; j < n; j++) {
+      scratch_[j * coord_size_ + d] = data[j];
+    }
+  }
+
+  constructor_.coords(scratch_.data(), n, coord_size_);
+}
+
+Writer::Writer(util::GeometryType geometry_type, CoordType coord_type,
+               const util::Constructor::Options& options)
+    : geometry_type_(geometry_type),
+      coord_type_(coord_type),
+      options_(options),
+      length_(0),
+      null_count_(0),
+      num_coords_(0) {
+  coord_size_ = options_.projection() == nullptr ? 3 : 2;
+  nesting_ = Nesting(geometry_type_);
+
+  offsets_.resize(nesting_);
+  for (auto& offsets : offsets_) {
+    offsets.push_back(0);
+  }
+
+  if (coord_type_ == CoordType::SEPARATED) {
+    coords_.resize(coord_size_);
+  } else {
+    coords_.resize(1);
+  }
+}
+
+namespace {
+
+bool IsEmpty(const Geography& geog) {
+  if (auto points = dynamic_cast<const PointGeography*>(&geog)) {
+    return points->Points().empty();
+  } else if (auto polylines = dynamic_cast<const PolylineGeography*>(&geog)) {
+    return polylines->Polylines().empty();
+  } else if (auto polygon = dynamic_cast<const PolygonGeography*>(&geog)) {
+    return polygon->Polygon()->num_loops() == 0;
+  } else if (auto polylines = dynamic_cast<const LaxPolylineGeography*>(&geog)) {
+    return polylines->Polylines().empty();
+  } else if (auto polygon = dynamic_cast<const LaxPolygonGeography*>(&geog)) {
+    return polygon->num_polygons() == 0;
+  } else if (auto collection = dynamic_cast<const GeographyCollection*>(&geog)) {
+    for (const auto& feature : collection->Features()) {
+      if (!IsEmpty(*feature)) {
+        return false;
+      }
+    }
+
+    return true;
+  } else {
+    throw Exception("Unsupported Geography subclass");
+  }
+}
+
+// Outer shells are loops with an even depth (0, 2, 4, etc.)
+std::vector<int> ShellLoops(const S2Polygon& polygon) {
+  std::vector<int> out;
+  for (int i = 0; i < polygon.num_loops(); i++) {
+    if ((polygon.loop(i)->depth() % 2) == 0) {
+      out.push_back(i);
+    }
+  }
+
+  return out;
+}
+
+util::GeometryType FeatureGeometryType(const Geography& geog) {
+  if (auto points = dynamic_cast<const PointGeography*>(&geog)) {
+    return points->Points().size() == 1 ? util::GeometryType::POINT
+                                        : util::GeometryType::MULTIPOINT;
+  } else if (auto polylines = dynamic_cast<const PolylineGeography*>(&geog)) {
+    return polylines->Polylines().size() == 1
+               ? util::GeometryType::LINESTRING
+               : util::GeometryType::MULTILINESTRING;
+  } else if (auto polygon = dynamic_cast<const PolygonGeography*>(&geog)) {
+    return ShellLoops(*polygon->Polygon()).size() == 1
+               ? util::GeometryType::POLYGON
+               : util::GeometryType::MULTIPOLYGON;
+  } else if (auto polylines = dynamic_cast<const LaxPolylineGeography*>(&geog)) {
+    return polylines->Polylines().size() == 1
+               ? util::GeometryType::LINESTRING
+               : util::GeometryType::MULTILINESTRING;
+  } else if (auto polygon = dynamic_cast<const LaxPolygonGeography*>(&geog)) {
+    return polygon->num_polygons() == 1 ? util::GeometryType::POLYGON
+                                        : util::GeometryType::MULTIPOLYGON;
+  } else {
+    return util::GeometryType::GEOMETRYCOLLECTION;
+  }
+}
+
+const char* GeometryTypeName(util::GeometryType geometry_type) {
+  switch (geometry_type) {
+    case util::GeometryType::POINT:
+      return "point";
+    case util::GeometryType::LINESTRING:
+      return "linestring";
+    case util::GeometryType::POLYGON:
+      return "polygon";
+    case util::GeometryType::MULTIPOINT:
+      return "multipoint";
+    case util::GeometryType::MULTILINESTRING:
+      return "multilinestring";
+    case util::GeometryType::MULTIPOLYGON:
+      return "multipolygon";
+    default:
+      return "geometrycollection";
+  }
+}
+
+}  // namespace
+
+util::GeometryType Writer::InferGeometryType(
+    const std::vector<const Geography*>& features) {
+  int out = util::GeometryType::GEOMETRY_TYPE_UNKNOWN;
+  for (const Geography* geog : features) {
+    if (geog == nullptr || IsEmpty(*geog)) {
+      continue;
+    }
+
+    util::GeometryType geometry_type = FeatureGeometryType(*geog);
+    if (geometry_type == util::GeometryType::GEOMETRYCOLLECTION) {
+      throw Exception("Can't write non-empty geometrycollection to GeoArrow");
+    }
+
+    if (out == util::GeometryType::GEOMETRY_TYPE_UNKNOWN) {
+      out = geometry_type;
+    } else if ((out - 1) % 3 != (geometry_type - 1) % 3) {
+      throw Exception(
+          std::string("Can't write mixed geometry types to GeoArrow (") +
+          GeometryTypeName(static_cast<util::GeometryType>(out)) + " and " +
+          GeometryTypeName(geometry_type) + ")");
+    } else if (geometry_type > out) {
+      // the multi version of a type is its single version + 3
+      out = geometry_type;
+    }
+  }
+
+  if (out == util::GeometryType::GEOMETRY_TYPE_UNKNOWN) {
+    return util::GeometryType::POINT;
+  } else {
+    return static_cast<util::GeometryType>(out);
+  }
+}
+
+void Writer::WriteFeature(const Geography* geog) {
+  AppendValidity(geog != nullptr);
+  if (geog == nullptr) {
+    null_count_++;
+  }
+
+  if (geog == nullptr || IsEmpty(*geog)) {
+    if (nesting_ == 0) {
+      WriteEmptyPoint();
+    } else {
+      EndPart(0);
+    }
+
+    return;
+  }
+
+  auto points = dynamic_cast<const PointGeography*>(geog);
+  auto polylines = dynamic_cast<const PolylineGeography*>(geog);
+  auto polygon = dynamic_cast<const PolygonGeography*>(geog);
+  auto lax_polylines = dynamic_cast<const LaxPolylineGeography*>(geog);
+  auto lax_polygon = dynamic_cast<const LaxPolygonGeography*>(geog);
+
+  switch (geometry_type_) {
+    case util::GeometryType::POINT:
+      if (points != nullptr && points->Points().size() == 1) {
+        WriteCoord(points->Points()[0]);
+        return;
+      }
+      break;
+
+    case util::GeometryType::MULTIPOINT:
+      if (points != nullptr) {
+        for (const S2Point& pt : points->Points()) {
+          WriteCoord(pt);
+        }
+        EndPart(0);
+        return;
+      }
+      break;
+
+    case util::GeometryType::LINESTRING:
+      if (polylines != nullptr && polylines->Polylines().size() == 1) {
+        WritePolyline(*polylines->Polylines()[0]);
+        EndPart(0);
+        return;
+      } else if (lax_polylines != nullptr &&
+                 lax_polylines->Polylines().size() == 1) {
+        WritePolyline(*lax_polylines->Polylines()[0]);
+        EndPart(0);
+        return;
+      }
+      break;
+
+    case util::GeometryType::MULTILINESTRING:
+      if (polylines != nullptr) {
+        for (const auto& polyline : polylines->Polylines()) {
+          WritePolyline(*polyline);
+          EndPart(1);
+        }
+        EndPart(0);
+        return;
+      } else if (lax_polylines != nullptr) {
+        for (const auto& polyline : lax_polylines->Polylines()) {
+          WritePolyline(*polyline);
+          EndPart(1);
+        }
+        EndPart(0);
+        return;
+      }
+      break;
+
+    case util::GeometryType::POLYGON:
+      if (polygon != nullptr) {
+        std::vector<int> shells = ShellLoops(*polygon->Polygon());
+        if (shells.size() == 1) {
+          WriteShell(*polygon->Polygon(), shells[0], 1);
+          EndPart(0);
+          return;
+        }
+      } else if (lax_polygon != nullptr && lax_polygon->num_polygons() == 1) {
+        const std::vector<int>& offsets = lax_polygon->LoopOffsets();
+        WriteShell(*lax_polygon->Polygon(), offsets[0], offsets[1], 1);
+        EndPart(0);
+        return;
+      }
+      break;
+
+    case util::GeometryType::MULTIPOLYGON:
+      if (polygon != nullptr) {
+        for (int loop_start : ShellLoops(*polygon->Polygon())) {
+          WriteShell(*polygon->Polygon(), loop_start, 2);
+          EndPart(1);
+        }
+        EndPart(0);
+        return;
+      } else if (lax_polygon != nullptr) {
+        const std::vector<int>& offsets = lax_polygon->LoopOffsets();
+        for (int i = 0; i < lax_polygon->num_polygons(); i++) {
+          WriteShell(*lax_polygon->Polygon(), offsets[i], offsets[i + 1], 2);
+          EndPart(1);
+        }
+        EndPart(0);
+        return;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  throw Exception(std::string("Can't write ") +
+                  GeometryTypeName(FeatureGeometryType(*geog)) +
+                  " feature as " + kExtensionNames[geometry_type_]);
+}
+
+void Writer::AppendValidity(bool valid) {
+  if ((length_ % 8) == 0) {
+    validity_.push_back(0);
+  }
+
+  if (valid) {
+    validity_.back() |= 0x01 << (length_ % 8);
+  }
+
+  length_++;
+}
+
+void Writer::WriteCoord(const S2Point& pt) {
+  double coord[3];
+  if (options_.projection() == nullptr) {
+    coord[0] = pt.x();
+    coord[1] = pt.y();
+    coord[2] = pt.z();
+  } else {
+    R2Point out = options_.projection()->Project(pt);
+    coord[0] = out.x();
+    coord[1] = out.y();
+  }
+
+  if (coord_type_ == CoordType::SEPARATED) {
+    for (int32_t d = 0; d < coord_size_; d++) {
+      coords_[d].push_back(coord[d]);
+    }
+  } else {
+    coords_[0].insert(coords_[0].end(), coord, coord + coord_size_);
+  }
+
+  num_coords_++;
+}
+
+void Writer::WriteEmptyPoint() {
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  if (coord_type_ == CoordType::SEPARATED) {
+    for (int32_t d = 0; d < coord_size_; d++) {
+      coords_[d].push_back(nan);
+    }
+  } else {
+    coords_[0].insert(coords_[0].end(), coord_size_, nan);
+  }
+
+  num_coords_++;
+}
+
+void Writer::WritePolyline(const S2Polyline& polyline) {
+  for (int i = 0; i < polyline.num_vertices(); i++) {
+    WriteCoord(polyline.vertex(i));
+  }
+}
+
+void Writer::WritePolyline(const S2LaxPolylineShape& polyline) {
+  for (int i = 0; i < polyline.num_vertices(); i++) {
+    WriteCoord(polyline.vertex(i));
+  }
+}
+
+void Writer::WriteShell(const S2Polygon& polygon, int loop_start,
+                        int ring_level) {
+  const S2Loop* shell = polygon.loop(loop_start);
+  WriteLoop(*shell, false);
+  EndPart(ring_level);
+
+  for (int j = loop_start + 1; j <= polygon.GetLastDescendant(loop_start);
+       j++) {
+    const S2Loop* loop = polygon.loop(j);
+    if (loop->depth() == (shell->depth() + 1)) {
+      WriteLoop(*loop, true);
+      EndPart(ring_level);
+    }
+  }
+}
+
+// Lax loops already have their interior on the left
+void Writer::WriteShell(const S2LaxPolygonShape& polygon, int loop_begin,
+                        int loop_end, int ring_level) {
+  for (int i = loop_begin; i < loop_end; i++) {
+    int n = polygon.num_loop_vertices(i);
+    if (n == 0) {
+      throw Exception("Unexpected S2LaxPolygonShape loop with 0 vertices");
+    }
+
+    for (int j = 0; j < n; j++) {
+      WriteCoord(polygon.loop_vertex(i, j));
+    }
+    WriteCoord(polygon.loop_vertex(i, 0));
+    EndPart(ring_level);
+  }
+}
+
+void Writer::WriteLoop(const S2Loop& loop, bool reverse) {
+  if (loop.num_vertices() == 0) {
+    throw Exception("Unexpected S2Loop with 0 vertices");
+  }
+
+  // holes are written in the reverse order such that all rings are
+  // written with the interior on the left
+  if (reverse) {
+    for (int i = loop.num_vertices() - 1; i >= 0; i--) {
+      WriteCoord(loop.vertex(i));
+    }
+    WriteCoord(loop.vertex(loop.num_vertices() - 1));
+  } else {
+    for (int i = 0; i < loop.num_vertices(); i++) {
+      WriteCoord(loop.vertex(i));
+    }
+    WriteCoord(loop.vertex(0));
+  }
+}
+
+void Writer::EndPart(int level) {
+  int64_t size;
+  if (level == (nesting_ - 1)) {
+    size = num_coords_;
+  } else {
+    size = offsets_[level + 1].size() - 1;
+  }
+
+  if (size > std::numeric_limits<int32_t>::max()) {
+    throw Exception("Too many coordinates for a GeoArrow array with 32-bit offsets");
+  }
+
+  offsets_[level].push_back(static_cast<int32_t>(size));
+}
+
+void Writer::Finish(struct ArrowSchema* out_schema,
+                    struct ArrowArray* out_array) {
+  static const char* dimension_names[] = {"x", "y", "z"};
+  // The names of the children of each level by geometry type
+  static const char* child_names[][4] = {
+      {"", "", "", ""},
+      {"", "", "", ""},
+      {"", "vertices", "", ""},
+      {"", "rings", "vertices", ""},
+      {"", "points", "", ""},
+      {"", "linestrings", "vertices", ""},
+      {"", "polygons", "rings", "vertices"}};
+
+  // Build the coordinate array (the innermost level)
+  struct ArrowSchema* schema;
+  struct ArrowArray* array;
+  auto priv = new ArrayPrivate();
+  auto schema_priv = new SchemaPrivate();
+
+  if (coord_type_ == CoordType::SEPARATED) {
+    schema_priv->format = "+s";
+    for (int32_t d = 0; d < coord_size_; d++) {
+      schema_priv->children.push_back(NewSchema("g", dimension_names[d]));
+      priv->children.push_back(NewDoubleArray(std::move(coords_[d])));
+    }
+  } else {
+    schema_priv->format = "+w:" + std::to_string(coord_size_);
+    schema_priv->children.push_back(
+        NewSchema("g", coord_size_ == 2 ? "xy" : "xyz"));
+    priv->children.push_back(NewDoubleArray(std::move(coords_[0])));
+  }
+
+  priv->buffers = {nullptr};
+  schema = new struct ArrowSchema;
+  array = new struct ArrowArray;
+  InitSchema(schema, schema_priv);
+  InitArray(array, num_coords_, 0, priv);
+
+  // Wrap it in the list levels, starting from the innermost one
+  for (int level = nesting_ - 1; level >= 0; level--) {
+    schema_priv = reinterpret_cast<SchemaPrivate*>(schema->private_data);
+    schema_priv->name = child_names[geometry_type_][level + 1];
+    schema->name = schema_priv->name.c_str();
+
+    priv = new ArrayPrivate();
+    priv->offsets = std::move(offsets_[level]);
+    priv->buffers = {nullptr, priv->offsets.data()};
+    priv->children.push_back(array);
+    schema_priv = new SchemaPrivate();
+    schema_priv->format = "+l";
+    schema_priv->children.push_back(schema);
+
+    schema = new struct ArrowSchema;
+    array = new struct ArrowArray;
+    InitSchema(schema, schema_priv);
+    InitArray(array, priv->offsets.size() - 1, 0, priv);
+  }
+
+  // The outermost level carries the validity buffer and the extension type
+  priv = reinterpret_cast<ArrayPrivate*>(array->private_data);
+  if (null_count_ > 0) {
+    priv->validity = std::move(validity_);
+    priv->buffers[0] = priv->validity.data();
+  }
+
+  schema_priv = reinterpret_cast<SchemaPrivate*>(schema->private_data);
+  schema_priv->metadata = ExtensionMetadata(geometry_type_);
+
+  InitSchema(out_schema, schema_priv);
+  InitArray(out_array, length_, null_count_, priv);
+  delete schema;
+  delete array;
+}
+
+}  // namespace geoarrow
+
+}  // namespace s2geography
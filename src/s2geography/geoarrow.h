@@ -0,0 +1,159 @@
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "constructor.h"
+#include "geoarrow-imports.h"
+#include "geography.h"
+
+// The Arrow C Data interface is ABI-stable and is defined here as described
+// in https://arrow.apache.org/docs/format/CDataInterface.html such that
+// no Arrow library is needed to read or write arrays.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace s2geography {
+
+namespace geoarrow {
+
+// Coordinates in GeoArrow's native encoding are either stored as one
+// buffer per dimension (a struct array of doubles) or as one buffer
+// of xyxyxy... (a fixed-size list array of doubles).
+enum class CoordType { SEPARATED, INTERLEAVED };
+
+// The Reader builds geographies from an Arrow array whose type is one of
+// the GeoArrow native extension types (geoarrow.point, geoarrow.linestring,
+// geoarrow.polygon, geoarrow.multipoint, geoarrow.multilinestring, or
+// geoarrow.multipolygon). Coordinates are passed to a
+// util::FeatureConstructor one ring or linestring at a time (without a copy
+// for interleaved coordinates), so the result is identical to building the
+// same features using the constructor from WKB or WKT. A Reader is cheap to
+// create and does not modify the array, so several Readers can read
+// features from the same array at once.
+class Reader {
+ public:
+  explicit Reader(const util::Constructor::Options& options);
+
+  // Checks the type of the array and throws Exception if it is not a
+  // supported GeoArrow type.
+  void Init(const struct ArrowSchema* schema);
+
+  // Returns the feature at position i (relative to the array's offset)
+  // or nullptr if that feature is null.
+  std::unique_ptr<Geography> ReadFeature(const struct ArrowArray* array,
+                                         int64_t i);
+
+  util::GeometryType geometry_type() const { return geometry_type_; }
+
+ private:
+  util::Constructor::Options options_;
+  util::FeatureConstructor constructor_;
+  util::GeometryType geometry_type_;
+  CoordType coord_type_;
+  int32_t coord_size_;
+  int nesting_;
+  std::vector<bool> large_offsets_;
+  std::vector<double> scratch_;
+
+  void ReadCoords(const struct ArrowArray* array, int64_t begin, int64_t end);
+  void ReadLinestring(const struct ArrowArray* array, int level, int64_t i,
+                      util::GeometryType geometry_type);
+  void ReadPolygon(const struct ArrowArray* array, int level, int64_t i);
+  void Range(const struct ArrowArray* array, int level, int64_t i,
+             int64_t* begin, int64_t* end);
+};
+
+// The Writer collects geographies into buffers laid out according to one
+// of the GeoArrow native extension types and exports them as an Arrow array.
+// Polygons are written with their shells counter-clockwise and holes
+// clockwise with the first vertex of each ring repeated at the end.
+class Writer {
+ public:
+  // If the projection in options is nullptr, coordinates are written as
+  // xyz unit vectors; otherwise, they are projected and written as xy.
+  Writer(util::GeometryType geometry_type, CoordType coord_type,
+         const util::Constructor::Options& options);
+
+  // Returns the simplest type that can represent all non-null features
+  // or throws Exception if there is no such type (e.g., for a mix of points
+  // and polygons or a non-empty collection).
+  static util::GeometryType InferGeometryType(
+      const std::vector<const Geography*>& features);
+
+  // Appends a feature (or a null feature if geog is nullptr).
+  void WriteFeature(const Geography* geog);
+
+  // Moves the result into out_schema and out_array, which must be released
+  // by the caller.
+  void Finish(struct ArrowSchema* out_schema, struct ArrowArray* out_array);
+
+ private:
+  util::GeometryType geometry_type_;
+  CoordType coord_type_;
+  util::Constructor::Options options_;
+  int32_t coord_size_;
+  int nesting_;
+  int64_t length_;
+  int64_t null_count_;
+  int64_t num_coords_;
+  std::vector<uint8_t> validity_;
+  std::vector<std::vector<int32_t>> offsets_;
+  std::vector<std::vector<double>> coords_;
+
+  void AppendValidity(bool valid);
+  void WriteCoord(const S2Point& pt);
+  void WriteEmptyPoint();
+  void WritePolyline(const S2Polyline& polyline);
+  void WritePolyline(const S2LaxPolylineShape& polyline);
+  void WriteShell(const S2Polygon& polygon, int loop_start, int ring_level);
+  void WriteShell(const S2LaxPolygonShape& polygon, int loop_begin,
+                  int loop_end, int ring_level);
+  void WriteLoop(const S2Loop& loop, bool reverse);
+  void EndPart(int level);
+};
+
+}  // namespace geoarrow
+
+}  // namespace s2geography
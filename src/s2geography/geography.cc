@@ -38,6 +38,12 @@ class S2ShapeWrapper : public S2Shape {
   ChainPosition chain_position(int edge_id) const {
     return shape_->chain_position(edge_id);
   }
+  // forward the type tag and encoding so that an index containing wrapped
+  // shapes can be encoded and decoded as the original shape type
+  TypeTag type_tag() const { return shape_->type_tag(); }
+  void Encode(Encoder* encoder, s2coding::CodingHint hint) const {
+    shape_->Encode(encoder, hint);
+  }
 
  private:
   S2Shape* shape_;
@@ -69,6 +75,30 @@ class S2RegionWrapper : public S2Region {
   S2Region* region_;
 };
 
+// Lax shapes are not S2Regions, so the region of a lax geography is
+// computed using an index of its shapes. The region owns this index (and
+// shares it with its clones) because it is only built when needed.
+class S2ShapeIndexOwningRegion : public S2Region {
+ public:
+  S2ShapeIndexOwningRegion(std::shared_ptr<MutableS2ShapeIndex> index)
+      : index_(std::move(index)), region_(index_.get()) {}
+  S2Region* Clone() const { return new S2ShapeIndexOwningRegion(index_); }
+  S2Cap GetCapBound() const { return region_.GetCapBound(); }
+  S2LatLngRect GetRectBound() const { return region_.GetRectBound(); }
+  void GetCellUnionBound(std::vector<S2CellId>* cell_ids) const {
+    return region_.GetCellUnionBound(cell_ids);
+  }
+  bool Contains(const S2Cell& cell) const { return region_.Contains(cell); }
+  bool MayIntersect(const S2Cell& cell) const {
+    return region_.MayIntersect(cell);
+  }
+  bool Contains(const S2Point& p) const { return region_.Contains(p); }
+
+ private:
+  std::shared_ptr<MutableS2ShapeIndex> index_;
+  S2ShapeIndexRegion<MutableS2ShapeIndex> region_;
+};
+
 void Geography::GetCellUnionBound(std::vector<S2CellId>* cell_ids) const {
   MutableS2ShapeIndex index;
   for (int i = 0; i < num_shapes(); i++) {
@@ -140,6 +170,31 @@ void PolygonGeography::GetCellUnionBound(
   polygon_->GetCellUnionBound(cell_ids);
 }
 
+int LaxPolylineGeography::num_shapes() const { return polylines_.size(); }
+
+std::unique_ptr<S2Shape> LaxPolylineGeography::Shape(int id) const {
+  return absl::make_unique<S2ShapeWrapper>(polylines_[id].get());
+}
+
+std::unique_ptr<S2Region> LaxPolylineGeography::Region() const {
+  auto index = std::make_shared<MutableS2ShapeIndex>();
+  for (const auto& polyline : polylines_) {
+    index->Add(absl::make_unique<S2ShapeWrapper>(polyline.get()));
+  }
+
+  return absl::make_unique<S2ShapeIndexOwningRegion>(std::move(index));
+}
+
+std::unique_ptr<S2Shape> LaxPolygonGeography::Shape(int id) const {
+  return absl::make_unique<S2ShapeWrapper>(polygon_.get());
+}
+
+std::unique_ptr<S2Region> LaxPolygonGeography::Region() const {
+  auto index = std::make_shared<MutableS2ShapeIndex>();
+  index->Add(absl::make_unique<S2ShapeWrapper>(polygon_.get()));
+  return absl::make_unique<S2ShapeIndexOwningRegion>(std::move(index));
+}
+
 int GeographyCollection::num_shapes() const { return total_shapes_; }
 
 std::unique_ptr<S2Shape> GeographyCollection::Shape(int id) const {
@@ -164,18 +219,71 @@ std::unique_ptr<S2Region> GeographyCollection::Region() const {
   return std::unique_ptr<S2Region>(region.release());
 }
 
+ShapeIndexGeography::ShapeIndexGeography(const Geography& geog)
+    : index_(&shape_index_), borrowed_(nullptr) {
+  // S2Polygons that were default-constructed (e.g., some empty polygons)
+  // don't have a shape in their index
+  auto polygon = dynamic_cast<const PolygonGeography*>(&geog);
+  if (polygon != nullptr && polygon->Polygon()->index().num_shape_ids() == 1) {
+    borrowed_ = polygon->Polygon().get();
+    index_ = &borrowed_->index();
+  } else {
+    Add(geog);
+  }
+}
+
+ShapeIndexGeography::ShapeIndexGeography(ShapeIndexGeography&& other)
+    : shape_index_(std::move(other.shape_index_)),
+      index_(&shape_index_),
+      borrowed_(other.borrowed_) {
+  if (borrowed_ != nullptr) {
+    index_ = &borrowed_->index();
+  }
+
+  other.index_ = &other.shape_index_;
+  other.borrowed_ = nullptr;
+}
+
+ShapeIndexGeography& ShapeIndexGeography::operator=(
+    ShapeIndexGeography&& other) {
+  if (this != &other) {
+    shape_index_ = std::move(other.shape_index_);
+    borrowed_ = other.borrowed_;
+    index_ = borrowed_ != nullptr ? &borrowed_->index() : &shape_index_;
+
+    other.index_ = &other.shape_index_;
+    other.borrowed_ = nullptr;
+  }
+
+  return *this;
+}
+
+int ShapeIndexGeography::Add(const Geography& geog) {
+  if (borrowed_ != nullptr) {
+    shape_index_.Add(absl::make_unique<S2Polygon::Shape>(borrowed_));
+    index_ = &shape_index_;
+    borrowed_ = nullptr;
+  }
+
+  int id = -1;
+  for (int i = 0; i < geog.num_shapes(); i++) {
+    id = shape_index_.Add(geog.Shape(i));
+  }
+  return id;
+}
+
 int ShapeIndexGeography::num_shapes() const {
-  return shape_index_.num_shape_ids();
+  return index_->num_shape_ids();
 }
 
 std::unique_ptr<S2Shape> ShapeIndexGeography::Shape(int id) const {
-  S2Shape* shape = shape_index_.shape(id);
+  S2Shape* shape = index_->shape(id);
   return std::unique_ptr<S2Shape>(new S2ShapeWrapper(shape));
 }
 
 std::unique_ptr<S2Region> ShapeIndexGeography::Region() const {
   auto region =
-      absl::make_unique<S2ShapeIndexRegion<MutableS2ShapeIndex>>(&shape_index_);
+      absl::make_unique<S2ShapeIndexRegion<MutableS2ShapeIndex>>(index_);
   // because Rtools for R 3.6 on Windows complains about a direct
   // return region
   return std::unique_ptr<S2Region>(region.release());
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <s2/s2lax_polygon_shape.h>
+#include <s2/s2lax_polyline_shape.h>
 #include <s2/s2polygon.h>
 #include <s2/s2polyline.h>
 #include <stdint.h>
@@ -133,6 +135,65 @@ class PolygonGeography : public Geography {
   std::unique_ptr<S2Polygon> polygon_;
 };
 
+// An Geography representing zero or more polylines using the
+// S2LaxPolylineShape class as the underlying representation. Constructing
+// an S2LaxPolylineShape only copies its vertices, which makes this class
+// cheaper to build and smaller than a PolylineGeography. Operations that
+// need an S2Polyline (e.g., linear referencing) build one when needed.
+class LaxPolylineGeography : public Geography {
+ public:
+  LaxPolylineGeography() {}
+  LaxPolylineGeography(
+      std::vector<std::unique_ptr<S2LaxPolylineShape>> polylines)
+      : polylines_(std::move(polylines)) {}
+
+  int dimension() const { return 1; }
+  int num_shapes() const;
+  std::unique_ptr<S2Shape> Shape(int id) const;
+  std::unique_ptr<S2Region> Region() const;
+
+  const std::vector<std::unique_ptr<S2LaxPolylineShape>>& Polylines() const {
+    return polylines_;
+  }
+
+ private:
+  std::vector<std::unique_ptr<S2LaxPolylineShape>> polylines_;
+};
+
+// An Geography representing zero or more polygons using the
+// S2LaxPolygonShape class as the underlying representation. Unlike an
+// S2Polygon, an S2LaxPolygonShape does not compute loop bounds, loop
+// nesting, or an index when it is built; instead, the simple features
+// structure is kept as offsets into the loops of the shape: polygon i is
+// made of loops LoopOffsets()[i] to LoopOffsets()[i + 1] - 1, the first of
+// which is the shell. Shells are oriented counter-clockwise and holes
+// clockwise (i.e., the interior is always on the left). Operations that need
+// an S2Polygon build one when needed.
+class LaxPolygonGeography : public Geography {
+ public:
+  LaxPolygonGeography()
+      : polygon_(new S2LaxPolygonShape()), loop_offsets_(1, 0) {}
+  LaxPolygonGeography(std::unique_ptr<S2LaxPolygonShape> polygon,
+                      std::vector<int> loop_offsets)
+      : polygon_(std::move(polygon)), loop_offsets_(std::move(loop_offsets)) {}
+
+  int dimension() const { return 2; }
+  int num_shapes() const { return 1; }
+  std::unique_ptr<S2Shape> Shape(int id) const;
+  std::unique_ptr<S2Region> Region() const;
+
+  const std::unique_ptr<S2LaxPolygonShape>& Polygon() const {
+    return polygon_;
+  }
+
+  int num_polygons() const { return loop_offsets_.size() - 1; }
+  const std::vector<int>& LoopOffsets() const { return loop_offsets_; }
+
+ private:
+  std::unique_ptr<S2LaxPolygonShape> polygon_;
+  std::vector<int> loop_offsets_;
+};
+
 // An Geography wrapping zero or more Geography objects. These objects
 // can be used to represent a simple features GEOMETRYCOLLECTION.
 class GeographyCollection : public Geography {
@@ -168,33 +229,42 @@ class GeographyCollection : public Geography {
 // one ShapeIndexGeography and use it repeatedly. This class does not
 // own any Geography objects that are added do it and thus is only
 // valid for the scope of those objects.
+//
+// An S2Polygon already maintains a MutableS2ShapeIndex containing its own
+// shape, so a ShapeIndexGeography constructed from a single
+// PolygonGeography borrows that index instead of building a second one.
+// If more shapes are added later, the polygon is copied into an index
+// owned by the ShapeIndexGeography first.
 class ShapeIndexGeography : public Geography {
  public:
   ShapeIndexGeography(
       MutableS2ShapeIndex::Options options = MutableS2ShapeIndex::Options())
-      : shape_index_(options) {}
+      : shape_index_(options), index_(&shape_index_), borrowed_(nullptr) {}
 
-  explicit ShapeIndexGeography(const Geography& geog) { Add(geog); }
+  explicit ShapeIndexGeography(const Geography& geog);
+
+  // index_ may point to shape_index_, so moves must point it at the new
+  // object's own index (unless it is borrowed from an S2Polygon)
+  ShapeIndexGeography(ShapeIndexGeography&& other);
+  ShapeIndexGeography& operator=(ShapeIndexGeography&& other);
+  ShapeIndexGeography(const ShapeIndexGeography&) = delete;
+  ShapeIndexGeography& operator=(const ShapeIndexGeography&) = delete;
 
   // Add a Geography to the index, returning the last shape_id
   // that was added to the index or -1 if no shapes were added
   // to the index.
-  int Add(const Geography& geog) {
-    int id = -1;
-    for (int i = 0; i < geog.num_shapes(); i++) {
-      id = shape_index_.Add(geog.Shape(i));
-    }
-    return id;
-  }
+  int Add(const Geography& geog);
 
   int num_shapes() const;
   std::unique_ptr<S2Shape> Shape(int id) const;
   std::unique_ptr<S2Region> Region() const;
 
-  const MutableS2ShapeIndex& ShapeIndex() const { return shape_index_; }
+  const MutableS2ShapeIndex& ShapeIndex() const { return *index_; }
 
  private:
   MutableS2ShapeIndex shape_index_;
+  const MutableS2ShapeIndex* index_;
+  const S2Polygon* borrowed_;
 };
 
 }  // namespace s2geography
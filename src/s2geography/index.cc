@@ -0,0 +1,49 @@
+
+#include "index.h"
+
+#include <s2/s2shapeutil_coding.h>
+#include <s2/util/coding/coder.h>
+
+namespace s2geography {
+
+void GeographyIndex::Encode(Encoder* encoder) const {
+  encoder->Ensure(Encoder::kVarintMax64 +
+                  values_.size() * Encoder::kVarintMax32);
+  encoder->put_varint64(values_.size());
+  for (int value : values_) {
+    encoder->put_varint32(value);
+  }
+
+  if (!s2shapeutil::CompactEncodeTaggedShapes(index_, encoder)) {
+    throw Exception("Can't encode shapes in GeographyIndex");
+  }
+
+  index_.Encode(encoder);
+}
+
+bool GeographyIndex::Decode(Decoder* decoder) {
+  uint64 num_values;
+  if (!decoder->get_varint64(&num_values)) {
+    return false;
+  }
+
+  values_.resize(num_values);
+  for (uint64 i = 0; i < num_values; i++) {
+    uint32 value;
+    if (!decoder->get_varint32(&value)) {
+      return false;
+    }
+
+    values_[i] = value;
+  }
+
+  // Shapes are fully decoded (i.e., copied) such that the index does not
+  // depend on the lifecycle of the encoded bytes
+  if (!index_.Init(decoder, s2shapeutil::FullDecodeShapeFactory(decoder))) {
+    return false;
+  }
+
+  return static_cast<uint64>(index_.num_shape_ids()) == num_values;
+}
+
+}  // namespace s2geography
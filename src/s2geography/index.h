@@ -1,7 +1,11 @@
 
 #pragma once
 
+#include <s2/util/coding/coder.h>
+
+#include <algorithm>
 #include <unordered_set>
+#include <vector>
 
 #include "geography.h"
 
@@ -33,10 +37,21 @@ class GeographyIndex {
 
   MutableS2ShapeIndex& MutableShapeIndex() { return index_; }
 
+  int num_values() const { return values_.size(); }
+
+  // Appends the indexed shapes, the index itself, and the value associated
+  // with each shape to encoder such that the index can be restored using
+  // Decode() without rebuilding it.
+  void Encode(Encoder* encoder) const;
+
+  // Restores an index written by Encode(). Returns false if the encoded data
+  // could not be decoded.
+  bool Decode(Decoder* decoder);
+
   class Iterator {
    public:
     Iterator(const GeographyIndex* index)
-        : index_(index), iterator_(&index_->ShapeIndex()) {}
+        : index_(index), iterator_(&index_->ShapeIndex()), epoch_(0) {}
 
     void Query(const std::vector<S2CellId>& covering,
                std::unordered_set<int>* indices) {
@@ -46,6 +61,45 @@ class GeographyIndex {
     }
 
     void Query(const S2CellId& cell_id, std::unordered_set<int>* indices) {
+      VisitValues(cell_id, [&](int value) { indices->insert(value); });
+    }
+
+    // Appends the values that may intersect covering to indices (in no
+    // particular order) without hashing: values already seen during this call
+    // are skipped using a visited array that is stamped with a new epoch for
+    // each call and reused between calls. This is usually much faster than
+    // collecting values into an std::unordered_set. Values must be
+    // non-negative.
+    void Query(const std::vector<S2CellId>& covering,
+               std::vector<int>* indices) {
+      if (++epoch_ == 0) {
+        // the epoch wrapped around: reset all stamps
+        std::fill(visited_.begin(), visited_.end(), 0);
+        epoch_ = 1;
+      }
+
+      for (const S2CellId& query_cell : covering) {
+        VisitValues(query_cell, [&](int value) {
+          if (static_cast<size_t>(value) >= visited_.size()) {
+            visited_.resize(value + 1, 0);
+          }
+
+          if (visited_[value] != epoch_) {
+            visited_[value] = epoch_;
+            indices->push_back(value);
+          }
+        });
+      }
+    }
+
+   private:
+    const GeographyIndex* index_;
+    MutableS2ShapeIndex::Iterator iterator_;
+    std::vector<uint32_t> visited_;
+    uint32_t epoch_;
+
+    template <typename Visitor>
+    void VisitValues(const S2CellId& cell_id, Visitor visit) {
       S2CellRelation relation = iterator_.Locate(cell_id);
 
       if (relation == S2CellRelation::INDEXED) {
@@ -54,7 +108,7 @@ class GeographyIndex {
         const S2ShapeIndexCell& index_cell = iterator_.cell();
         for (int k = 0; k < index_cell.num_clipped(); k++) {
           int shape_id = index_cell.clipped(k).shape_id();
-          indices->insert(index_->value(shape_id));
+          visit(index_->value(shape_id));
         }
       } else if (relation == S2CellRelation::SUBDIVIDED) {
         // Promising! the index has a child cell of iterator_.id()
@@ -68,7 +122,7 @@ class GeographyIndex {
           const S2ShapeIndexCell& index_cell = iterator_.cell();
           for (int k = 0; k < index_cell.num_clipped(); k++) {
             int shape_id = index_cell.clipped(k).shape_id();
-            indices->insert(index_->value(shape_id));
+            visit(index_->value(shape_id));
           }
 
           // go to the next cell in the index
@@ -78,10 +132,6 @@ class GeographyIndex {
 
       // else: relation == S2CellRelation::DISJOINT (do nothing)
     }
-
-   private:
-    const GeographyIndex* index_;
-    MutableS2ShapeIndex::Iterator iterator_;
   };
 
  private:
@@ -0,0 +1,94 @@
+
+#include "join.h"
+
+#include <algorithm>
+
+namespace s2geography {
+
+void CoveringJoin::AddLeft(const std::vector<S2CellId>& covering, int value) {
+  AddEntries(covering, value, &left_);
+}
+
+void CoveringJoin::AddRight(const std::vector<S2CellId>& covering,
+                            int value) {
+  AddEntries(covering, value, &right_);
+}
+
+void CoveringJoin::AddEntries(const std::vector<S2CellId>& covering,
+                              int value, std::vector<Entry>* entries) {
+  for (const S2CellId& cell_id : covering) {
+    entries->push_back({cell_id.range_min(), cell_id.range_max(), value});
+  }
+}
+
+void CoveringJoin::Clear() {
+  left_.clear();
+  right_.clear();
+}
+
+void CoveringJoin::Join(std::vector<std::pair<int, int>>* pairs) {
+  pairs->clear();
+
+  // Any two cells are either nested or disjoint, so two cells intersect
+  // if and only if their leaf cell ranges overlap. Sorting by range_min (and
+  // by range_max descending such that a parent cell comes before any child
+  // that shares its range_min) lets us sweep both sides together keeping
+  // a stack of "open" cells for each side, where each cell in a stack
+  // contains the cell above it. Each intersecting pair is found exactly
+  // once: when the entry with the larger range_min (or the one that sorts
+  // last if they are equal) is visited, the other entry is on the
+  // opposite stack.
+  auto entry_less = [](const Entry& a, const Entry& b) {
+    if (a.range_min != b.range_min) {
+      return a.range_min < b.range_min;
+    } else {
+      return a.range_max > b.range_max;
+    }
+  };
+
+  std::sort(left_.begin(), left_.end(), entry_less);
+  std::sort(right_.begin(), right_.end(), entry_less);
+
+  std::vector<const Entry*> left_stack;
+  std::vector<const Entry*> right_stack;
+
+  auto pop_before = [](std::vector<const Entry*>* stack, S2CellId range_min) {
+    while (!stack->empty() && stack->back()->range_max < range_min) {
+      stack->pop_back();
+    }
+  };
+
+  auto left = left_.begin();
+  auto right = right_.begin();
+  while (left != left_.end() || right != right_.end()) {
+    bool visit_left = right == right_.end() ||
+                      (left != left_.end() && !entry_less(*right, *left));
+
+    const Entry& entry = visit_left ? *left : *right;
+    pop_before(&left_stack, entry.range_min);
+    pop_before(&right_stack, entry.range_min);
+
+    if (visit_left) {
+      for (const Entry* other : right_stack) {
+        pairs->emplace_back(entry.value, other->value);
+      }
+
+      left_stack.push_back(&entry);
+      ++left;
+    } else {
+      for (const Entry* other : left_stack) {
+        pairs->emplace_back(other->value, entry.value);
+      }
+
+      right_stack.push_back(&entry);
+      ++right;
+    }
+  }
+
+  // features whose coverings intersect in more than one cell
+  // are reported more than once
+  std::sort(pairs->begin(), pairs->end());
+  pairs->erase(std::unique(pairs->begin(), pairs->end()), pairs->end());
+}
+
+}  // namespace s2geography
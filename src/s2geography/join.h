@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include <s2/s2cell_id.h>
+
+#include <utility>
+#include <vector>
+
+namespace s2geography {
+
+// The CoveringJoin finds all pairs of features from two collections whose
+// coverings intersect. Rather than probing an index once for every cell in
+// the covering of every feature on one side (a random seek per cell), both
+// sides are sorted by S2CellId and walked together in a single pass. This
+// emits candidate pairs in bulk that can then be refined using an exact
+// predicate.
+class CoveringJoin {
+ public:
+  // Adds the (not necessarily normalized) covering of a feature to the left
+  // or right side of the join. value is the identifier reported for this
+  // feature in the output.
+  void AddLeft(const std::vector<S2CellId>& covering, int value);
+  void AddRight(const std::vector<S2CellId>& covering, int value);
+
+  // Sets pairs to the unique (left value, right value) pairs whose
+  // coverings intersect, sorted by left value and then by right value.
+  void Join(std::vector<std::pair<int, int>>* pairs);
+
+  void Clear();
+
+ private:
+  struct Entry {
+    S2CellId range_min;
+    S2CellId range_max;
+    int value;
+  };
+
+  std::vector<Entry> left_;
+  std::vector<Entry> right_;
+
+  static void AddEntries(const std::vector<S2CellId>& covering, int value,
+                         std::vector<Entry>* entries);
+};
+
+}  // namespace s2geography
@@ -0,0 +1,367 @@
+
+#include "relate.h"
+
+#include <s2/s2cell_range_iterator.h>
+#include <s2/s2contains_point_query.h>
+#include <s2/s2crossing_edge_query.h>
+#include <s2/s2edge_crosser.h>
+#include <s2/s2padded_cell.h>
+#include <s2/s2predicates.h>
+
+#include "predicates.h"
+
+namespace s2geography {
+
+namespace {
+
+// The shapes of an index as they matter to the single-pass relate
+struct IndexSummary {
+  // The dimension of all non-empty shapes, -1 if there are none, or -2 if
+  // the non-empty shapes have more than one dimension
+  int dimension;
+  int num_shapes;
+  bool full;
+  // True if a polyline has a chain made only of degenerate edges, whose
+  // containment depends on the polyline model
+  bool degenerate;
+};
+
+IndexSummary Summarize(const MutableS2ShapeIndex& index) {
+  IndexSummary out{-1, 0, false, false};
+  for (int i = 0; i < index.num_shape_ids(); i++) {
+    const S2Shape* shape = index.shape(i);
+    if (shape == nullptr || shape->is_empty()) {
+      continue;
+    }
+
+    if (shape->is_full()) {
+      out.full = true;
+    }
+
+    if (out.dimension == -1) {
+      out.dimension = shape->dimension();
+    } else if (out.dimension != shape->dimension()) {
+      out.dimension = -2;
+    }
+
+    out.num_shapes++;
+
+    if (shape->dimension() == 1) {
+      for (int j = 0; j < shape->num_chains(); j++) {
+        S2Shape::Chain chain = shape->chain(j);
+        bool degenerate = true;
+        for (int k = 0; k < chain.length && degenerate; k++) {
+          degenerate = shape->chain_edge(j, k).IsDegenerate();
+        }
+
+        out.degenerate = out.degenerate || degenerate;
+      }
+    }
+  }
+
+  return out;
+}
+
+// How the edges of two geographies meet
+enum class EdgeRelation {
+  // No two edges share a point
+  kDisjoint,
+  // Two edges cross at a point that is interior to both
+  kCrossing,
+  // A vertex of one geography lies on an edge of the other (which includes
+  // shared vertices and collinear overlaps)
+  kContact
+};
+
+bool OnEdge(const S2Point& point, const S2Shape::Edge& edge) {
+  return s2pred::CompareEdgeDistance(point, edge.v0, edge.v1,
+                                     S1ChordAngle::Zero()) <= 0;
+}
+
+// Finds contact and crossings between the edges of a single index cell of
+// one index and the edges of all cells of the other index that it contains
+// (or that are equal to it).
+class CellCrosser {
+ public:
+  CellCrosser(const MutableS2ShapeIndex& a_index,
+              const MutableS2ShapeIndex& b_index)
+      : a_index_(a_index), b_index_(b_index), b_query_(&b_index) {}
+
+  // Given two iterators positioned such that ai->id() contains bi->id(),
+  // tests the edges of ai's cell against the edges of B's cells that are
+  // descendants of ai->id() and advances both iterators past ai->id().
+  // Returns false (without advancing ai) as soon as a crossing or contact is
+  // found, which is recorded in relation.
+  bool Visit(S2CellRangeIterator<MutableS2ShapeIndex::Iterator>* ai,
+             S2CellRangeIterator<MutableS2ShapeIndex::Iterator>* bi,
+             EdgeRelation* relation) {
+    const S2ShapeIndexCell& a_cell = ai->iterator().cell();
+    if (a_cell.num_edges() == 0) {
+      bi->SeekBeyond(*ai);
+      ai->Next();
+      return true;
+    }
+
+    GetEdges(a_index_, a_cell, &a_edges_);
+
+    // As in s2shapeutil::VisitCrossingEdgePairs(), test all pairs directly if
+    // there are only a few edges of B in this cell or use an
+    // S2CrossingEdgeQuery to narrow down the candidates otherwise
+    static const int kEdgeQueryMinEdges = 23;
+    b_edges_.clear();
+    bool use_query = false;
+    do {
+      const S2ShapeIndexCell& b_cell = bi->iterator().cell();
+      if (!use_query && b_cell.num_edges() > 0) {
+        AppendEdges(b_index_, b_cell, &b_edges_);
+        use_query = b_edges_.size() >= kEdgeQueryMinEdges;
+      }
+      bi->Next();
+    } while (!bi->done() && bi->id() <= ai->range_max());
+
+    if (use_query) {
+      S2PaddedCell root(ai->id(), 0);
+      for (const S2Shape::Edge& a : a_edges_) {
+        bool visited = b_query_.VisitCells(
+            a.v0, a.v1, root, [&](const S2ShapeIndexCell& b_cell) {
+              GetEdges(b_index_, b_cell, &b_cell_edges_);
+              return TestPairs(a, b_cell_edges_, relation);
+            });
+        if (!visited) {
+          return false;
+        }
+      }
+    } else {
+      for (const S2Shape::Edge& a : a_edges_) {
+        if (!TestPairs(a, b_edges_, relation)) {
+          return false;
+        }
+      }
+    }
+
+    ai->Next();
+    return true;
+  }
+
+ private:
+  using EdgeVector = absl::InlinedVector<S2Shape::Edge, 16>;
+
+  static void AppendEdges(const MutableS2ShapeIndex& index,
+                          const S2ShapeIndexCell& cell, EdgeVector* edges) {
+    for (int i = 0; i < cell.num_clipped(); i++) {
+      const S2ClippedShape& clipped = cell.clipped(i);
+      const S2Shape* shape = index.shape(clipped.shape_id());
+      for (int j = 0; j < clipped.num_edges(); j++) {
+        edges->push_back(shape->edge(clipped.edge(j)));
+      }
+    }
+  }
+
+  static void GetEdges(const MutableS2ShapeIndex& index,
+                       const S2ShapeIndexCell& cell, EdgeVector* edges) {
+    edges->clear();
+    AppendEdges(index, cell, edges);
+  }
+
+  static bool TestPairs(const S2Shape::Edge& a, const EdgeVector& b_edges,
+                        EdgeRelation* relation) {
+    S2EdgeCrosser crosser(&a.v0, &a.v1);
+    for (const S2Shape::Edge& b : b_edges) {
+      if (OnEdge(a.v0, b) || OnEdge(a.v1, b) || OnEdge(b.v0, a) ||
+          OnEdge(b.v1, a)) {
+        *relation = EdgeRelation::kContact;
+        return false;
+      }
+
+      if (!a.IsDegenerate() && !b.IsDegenerate() &&
+          crosser.CrossingSign(&b.v0, &b.v1) > 0) {
+        *relation = EdgeRelation::kCrossing;
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  const MutableS2ShapeIndex& a_index_;
+  const MutableS2ShapeIndex& b_index_;
+  S2CrossingEdgeQuery b_query_;
+  EdgeVector a_edges_;
+  EdgeVector b_edges_;
+  EdgeVector b_cell_edges_;
+};
+
+// Walks the index cells of index1 and index2 that overlap (like
+// s2shapeutil::VisitCrossingEdgePairs()) and tests the edges they contain,
+// stopping at the first crossing or contact.
+EdgeRelation RelateEdges(const MutableS2ShapeIndex& index1,
+                         const MutableS2ShapeIndex& index2) {
+  EdgeRelation relation = EdgeRelation::kDisjoint;
+  auto it1 = MakeS2CellRangeIterator(&index1);
+  auto it2 = MakeS2CellRangeIterator(&index2);
+  CellCrosser crosser12(index1, index2);
+  CellCrosser crosser21(index2, index1);
+
+  while (!it1.done() && !it2.done()) {
+    if (it1.range_max() < it2.range_min()) {
+      it1.SeekTo(it2);
+    } else if (it2.range_max() < it1.range_min()) {
+      it2.SeekTo(it1);
+    } else if (it1.id().lsb() >= it2.id().lsb()) {
+      // The cell of index1 contains (or is equal to) the cell of index2
+      if (!crosser12.Visit(&it1, &it2, &relation)) {
+        break;
+      }
+    } else if (!crosser21.Visit(&it2, &it1, &relation)) {
+      break;
+    }
+  }
+
+  return relation;
+}
+
+// Tests the first vertex of each chain of index against the polygons of
+// other. Without any contact between the two, each chain is either entirely
+// inside or entirely outside the interior of other.
+void ChainsContained(const MutableS2ShapeIndex& index,
+                     const MutableS2ShapeIndex& other, bool* any, bool* all) {
+  auto query = MakeS2ContainsPointQuery(&other);
+  *any = false;
+  *all = true;
+
+  for (int i = 0; i < index.num_shape_ids(); i++) {
+    const S2Shape* shape = index.shape(i);
+    if (shape == nullptr) {
+      continue;
+    }
+
+    for (int j = 0; j < shape->num_chains(); j++) {
+      if (shape->chain(j).length == 0) {
+        continue;
+      }
+
+      bool contained = query.Contains(shape->chain_edge(j, 0).v0);
+      *any = *any || contained;
+      *all = *all && contained;
+    }
+  }
+}
+
+int RelateBooleanOperation(const ShapeIndexGeography& geog1,
+                           const ShapeIndexGeography& geog2,
+                           const S2BooleanOperation::Options& options,
+                           int mask) {
+  S2BooleanOperation::Options closed_options = options;
+  closed_options.set_polygon_model(S2BooleanOperation::PolygonModel::CLOSED);
+  closed_options.set_polyline_model(S2BooleanOperation::PolylineModel::CLOSED);
+  S2BooleanOperation::Options open_options = options;
+  open_options.set_polygon_model(S2BooleanOperation::PolygonModel::OPEN);
+  open_options.set_polyline_model(S2BooleanOperation::PolylineModel::OPEN);
+
+  int code = 0;
+  if ((mask & RELATE_INTERSECTS) && s2_intersects(geog1, geog2, options)) {
+    code |= RELATE_INTERSECTS;
+  }
+
+  if ((mask & RELATE_TOUCHES) &&
+      s2_intersects(geog1, geog2, closed_options) &&
+      !s2_intersects(geog1, geog2, open_options)) {
+    code |= RELATE_TOUCHES;
+  }
+
+  if ((mask & RELATE_CONTAINS) && s2_contains(geog1, geog2, open_options)) {
+    code |= RELATE_CONTAINS;
+  }
+
+  if ((mask & RELATE_WITHIN) && s2_contains(geog2, geog1, open_options)) {
+    code |= RELATE_WITHIN;
+  }
+
+  if ((mask & RELATE_COVERS) && s2_contains(geog1, geog2, closed_options)) {
+    code |= RELATE_COVERS;
+  }
+
+  if ((mask & RELATE_COVERED_BY) &&
+      s2_contains(geog2, geog1, closed_options)) {
+    code |= RELATE_COVERED_BY;
+  }
+
+  if ((mask & RELATE_EQUALS) && s2_equals(geog1, geog2, options)) {
+    code |= RELATE_EQUALS;
+  }
+
+  return code;
+}
+
+}  // namespace
+
+int s2_relate(const ShapeIndexGeography& geog1,
+              const ShapeIndexGeography& geog2,
+              const S2BooleanOperation::Options& options, int mask) {
+  const MutableS2ShapeIndex& index1 = geog1.ShapeIndex();
+  const MutableS2ShapeIndex& index2 = geog2.ShapeIndex();
+  IndexSummary summary1 = Summarize(index1);
+  IndexSummary summary2 = Summarize(index2);
+
+  if (summary1.full || summary2.full || summary1.degenerate ||
+      summary2.degenerate) {
+    return RelateBooleanOperation(geog1, geog2, options, mask);
+  }
+
+  // Empty geographies are only related to each other (by equals)
+  if (summary1.dimension == -1 || summary2.dimension == -1) {
+    bool both_empty = summary1.dimension == -1 && summary2.dimension == -1;
+    return both_empty ? (mask & RELATE_EQUALS) : 0;
+  }
+
+  // A proper crossing only rules out containment if each side is a single
+  // polygon or a collection of shapes with the same dimension that can't
+  // overlap each other without contact (points or polylines)
+  if (summary1.dimension == -2 || summary2.dimension == -2 ||
+      (summary1.dimension == 2 && summary1.num_shapes > 1) ||
+      (summary2.dimension == 2 && summary2.num_shapes > 1)) {
+    return RelateBooleanOperation(geog1, geog2, options, mask);
+  }
+
+  // A proper crossing means that each side has points in the interior and
+  // outside the closure of the other, which only leaves intersects; contact
+  // depends on the polygon and polyline models
+  EdgeRelation relation = RelateEdges(index1, index2);
+  if (relation == EdgeRelation::kCrossing) {
+    return RELATE_INTERSECTS & mask;
+  } else if (relation == EdgeRelation::kContact) {
+    return RelateBooleanOperation(geog1, geog2, options, mask);
+  }
+
+  // Without contact the boundaries are disjoint, so the models don't matter:
+  // covers is contains, covered_by is within, nothing touches, and nothing is
+  // equal
+  if ((mask & ~(RELATE_TOUCHES | RELATE_EQUALS)) == 0) {
+    return 0;
+  }
+
+  bool any1_in_2, all1_in_2, any2_in_1, all2_in_1;
+  ChainsContained(index1, index2, &any1_in_2, &all1_in_2);
+  ChainsContained(index2, index1, &any2_in_1, &all2_in_1);
+
+  int code = 0;
+  if (any1_in_2 || any2_in_1) {
+    code |= RELATE_INTERSECTS;
+  }
+
+  // geog1 contains geog2 if the boundary of geog2 is in the interior of geog1
+  // and the boundary of geog1 is outside geog2
+  if (summary1.dimension == 2 && all2_in_1 &&
+      (summary2.dimension != 2 || !any1_in_2)) {
+    code |= RELATE_CONTAINS | RELATE_COVERS;
+  }
+
+  if (summary2.dimension == 2 && all1_in_2 &&
+      (summary1.dimension != 2 || !any2_in_1)) {
+    code |= RELATE_WITHIN | RELATE_COVERED_BY;
+  }
+
+  return code & mask;
+}
+
+}  // namespace s2geography
@@ -0,0 +1,43 @@
+
+#pragma once
+
+#include <s2/s2boolean_operation.h>
+
+#include "geography.h"
+
+namespace s2geography {
+
+// The bits of the relation code returned by s2_relate(). Each bit has the
+// meaning of the predicate with the same name: intersects and equals use the
+// polygon and polyline model of the options passed to s2_relate(), contains
+// and within use the open model, covers and covered_by use the closed model,
+// and touches is true if the closures intersect but the interiors do not.
+enum RelateFlag {
+  RELATE_INTERSECTS = 1,
+  RELATE_TOUCHES = 2,
+  RELATE_CONTAINS = 4,
+  RELATE_WITHIN = 8,
+  RELATE_COVERS = 16,
+  RELATE_COVERED_BY = 32,
+  RELATE_EQUALS = 64,
+  RELATE_ALL = 127
+};
+
+// Computes the relationships between geog1 and geog2 that are requested by
+// mask and returns the ones that hold as a combination of RelateFlag bits.
+// Rather than running one S2BooleanOperation per relationship (two for
+// touches), the overlapping index cells of both geographies are walked once
+// to find proper crossings and any contact between a vertex and an edge; when
+// there is no such contact, every relationship is determined by the crossings
+// and by testing one vertex of each chain against the other geography using
+// an S2ContainsPointQuery.
+// Pairs whose boundaries touch (where the polygon and polyline models
+// matter), geographies that mix dimensions or contain more than one polygon
+// shape, and full polygons are evaluated using S2BooleanOperation for the
+// requested relationships only.
+int s2_relate(const ShapeIndexGeography& geog1,
+              const ShapeIndexGeography& geog2,
+              const S2BooleanOperation::Options& options,
+              int mask = RELATE_ALL);
+
+}  // namespace s2geography
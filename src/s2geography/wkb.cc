@@ -0,0 +1,564 @@
+
+#include "wkb.h"
+
+#include <s2/s2projections.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace s2geography {
+
+namespace {
+
+// The byte order of this platform using the WKB endian flag (1 for little
+// endian and 0 for big endian)
+uint8_t NativeEndian() {
+  uint32_t one = 1;
+  uint8_t first_byte;
+  memcpy(&first_byte, &one, 1);
+  return first_byte;
+}
+
+uint32_t SwapUInt32(uint32_t value) {
+  return ((value & 0x000000ff) << 24) | ((value & 0x0000ff00) << 8) |
+         ((value & 0x00ff0000) >> 8) | ((value & 0xff000000) >> 24);
+}
+
+void SwapDouble(double* value) {
+  uint8_t bytes[sizeof(double)];
+  memcpy(bytes, value, sizeof(double));
+  for (size_t i = 0; i < sizeof(double) / 2; i++) {
+    std::swap(bytes[i], bytes[sizeof(double) - 1 - i]);
+  }
+  memcpy(value, bytes, sizeof(double));
+}
+
+// Flags used by extended WKB
+constexpr uint32_t kEWKBZ = 0x80000000;
+constexpr uint32_t kEWKBM = 0x40000000;
+constexpr uint32_t kEWKBSRID = 0x20000000;
+
+// The size of a geometry header (byte order, geometry type, and size)
+constexpr int64_t kHeaderSize = 1 + sizeof(uint32_t) + sizeof(uint32_t);
+constexpr int64_t kCoordSize = 2 * sizeof(double);
+
+// Outer shells of a polygon are loops with an even depth
+std::vector<int> ShellLoops(const S2Polygon& polygon) {
+  std::vector<int> shells;
+  for (int i = 0; i < polygon.num_loops(); i++) {
+    if ((polygon.loop(i)->depth() % 2) == 0) {
+      shells.push_back(i);
+    }
+  }
+
+  return shells;
+}
+
+// Calls func(loop) for the shell at loop_start and each of its holes
+template <typename Func>
+void ForEachRing(const S2Polygon& polygon, int loop_start, Func func) {
+  const S2Loop* shell = polygon.loop(loop_start);
+  func(shell);
+  for (int j = loop_start + 1; j <= polygon.GetLastDescendant(loop_start);
+       j++) {
+    const S2Loop* loop = polygon.loop(j);
+    if (loop->depth() == (shell->depth() + 1)) {
+      func(loop);
+    }
+  }
+}
+
+int64_t ShellSize(const S2Polygon& polygon, int loop_start) {
+  int64_t size = kHeaderSize;
+  ForEachRing(polygon, loop_start, [&](const S2Loop* loop) {
+    size += sizeof(uint32_t) + (loop->num_vertices() + 1) * kCoordSize;
+  });
+  return size;
+}
+
+int64_t LaxShellSize(const S2LaxPolygonShape& polygon, int loop_begin,
+                     int loop_end) {
+  int64_t size = kHeaderSize;
+  for (int i = loop_begin; i < loop_end; i++) {
+    size += sizeof(uint32_t) + (polygon.num_loop_vertices(i) + 1) * kCoordSize;
+  }
+  return size;
+}
+
+}  // namespace
+
+WKBReader::WKBReader(const util::Constructor::Options& options)
+    : constructor_(options),
+      data_(nullptr),
+      end_(nullptr),
+      swap_endian_(false) {}
+
+std::unique_ptr<Geography> WKBReader::ReadFeature(const uint8_t* bytes,
+                                                  int64_t size) {
+  data_ = bytes;
+  end_ = bytes + size;
+
+  constructor_.feat_start();
+  ReadGeometry();
+  return constructor_.finish_feature();
+}
+
+void WKBReader::ReadGeometry() {
+  uint8_t endian = ReadUInt8();
+  if (endian > 1) {
+    throw WKBException("Invalid WKB byte order: " + std::to_string(endian));
+  }
+
+  swap_endian_ = endian != NativeEndian();
+
+  uint32_t geometry_type = ReadUInt32();
+  bool has_z = geometry_type & kEWKBZ;
+  bool has_m = geometry_type & kEWKBM;
+  bool has_srid = geometry_type & kEWKBSRID;
+  geometry_type &= 0x0000ffff;
+
+  if (geometry_type >= 3000) {
+    has_z = true;
+    has_m = true;
+    geometry_type -= 3000;
+  } else if (geometry_type >= 2000) {
+    has_m = true;
+    geometry_type -= 2000;
+  } else if (geometry_type >= 1000) {
+    has_z = true;
+    geometry_type -= 1000;
+  }
+
+  if (has_srid) {
+    ReadUInt32();
+  }
+
+  int32_t coord_size = 2 + has_z + has_m;
+  auto type = static_cast<util::GeometryType>(geometry_type);
+
+  switch (type) {
+    case util::GeometryType::POINT: {
+      // POINT EMPTY is written as a point whose coordinates are all nan
+      ReadCoords(1, coord_size);
+      bool empty = true;
+      for (int32_t i = 0; i < coord_size; i++) {
+        empty = empty && std::isnan(scratch_[i]);
+      }
+
+      if (empty) {
+        constructor_.geom_start(type, 0);
+      } else {
+        constructor_.geom_start(type, 1);
+        constructor_.coords(scratch_.data(), 1, coord_size);
+      }
+
+      constructor_.geom_end();
+      break;
+    }
+
+    case util::GeometryType::LINESTRING: {
+      uint32_t n = ReadUInt32();
+      ReadCoords(n, coord_size);
+      constructor_.geom_start(type, n);
+      constructor_.coords(scratch_.data(), n, coord_size);
+      constructor_.geom_end();
+      break;
+    }
+
+    case util::GeometryType::POLYGON: {
+      // sizes are checked before they are passed to the constructor, which
+      // may use them to reserve memory
+      uint32_t num_rings = ReadUInt32();
+      CheckAvailable(static_cast<int64_t>(num_rings) * sizeof(uint32_t));
+      constructor_.geom_start(type, num_rings);
+      for (uint32_t i = 0; i < num_rings; i++) {
+        uint32_t n = ReadUInt32();
+        constructor_.ring_start(n);
+        ReadCoords(n, coord_size);
+        constructor_.coords(scratch_.data(), n, coord_size);
+        constructor_.ring_end();
+      }
+      constructor_.geom_end();
+      break;
+    }
+
+    case util::GeometryType::MULTIPOINT:
+    case util::GeometryType::MULTILINESTRING:
+    case util::GeometryType::MULTIPOLYGON:
+    case util::GeometryType::GEOMETRYCOLLECTION: {
+      // the smallest possible part is an empty multi geometry or collection
+      uint32_t num_parts = ReadUInt32();
+      CheckAvailable(static_cast<int64_t>(num_parts) * 9);
+      constructor_.geom_start(type, num_parts);
+      for (uint32_t i = 0; i < num_parts; i++) {
+        // each part has its own byte order
+        ReadGeometry();
+      }
+      constructor_.geom_end();
+      break;
+    }
+
+    default:
+      throw WKBException("Invalid WKB geometry type: " +
+                         std::to_string(geometry_type));
+  }
+}
+
+void WKBReader::ReadCoords(uint32_t n, int32_t coord_size) {
+  int64_t num_values = static_cast<int64_t>(n) * coord_size;
+  CheckAvailable(num_values * static_cast<int64_t>(sizeof(double)));
+
+  scratch_.resize(num_values);
+  memcpy(scratch_.data(), data_, num_values * sizeof(double));
+  data_ += num_values * sizeof(double);
+
+  if (swap_endian_) {
+    for (double& value : scratch_) {
+      SwapDouble(&value);
+    }
+  }
+}
+
+uint8_t WKBReader::ReadUInt8() {
+  CheckAvailable(sizeof(uint8_t));
+  uint8_t value = *data_;
+  data_ += sizeof(uint8_t);
+  return value;
+}
+
+uint32_t WKBReader::ReadUInt32() {
+  CheckAvailable(sizeof(uint32_t));
+  uint32_t value;
+  memcpy(&value, data_, sizeof(uint32_t));
+  data_ += sizeof(uint32_t);
+  return swap_endian_ ? SwapUInt32(value) : value;
+}
+
+void WKBReader::CheckAvailable(int64_t n) {
+  if (n > (end_ - data_)) {
+    throw WKBException("Unexpected end of WKB: expected " +
+                       std::to_string(n) + " bytes but found " +
+                       std::to_string(end_ - data_));
+  }
+}
+
+WKBWriter::WKBWriter(const util::Constructor::Options& options,
+                     uint8_t endian)
+    : projection_(options.projection()),
+      plate_carree_scale_(0),
+      endian_(endian),
+      swap_endian_(endian != NativeEndian()),
+      out_(nullptr) {
+  if (projection_ == nullptr) {
+    throw Exception("WKBWriter requires a projection");
+  }
+
+  // The plate carree projection is computed inline (using the same
+  // operations as PlateCarreeProjection::Project() so that the result is
+  // identical) to avoid a virtual call for every vertex.
+  if (dynamic_cast<S2::PlateCarreeProjection*>(projection_) != nullptr) {
+    plate_carree_scale_ =
+        projection_->FromLatLng(S2LatLng::FromRadians(0, 1)).x();
+  }
+}
+
+int64_t WKBWriter::SizeOf(const Geography& geog) const {
+  if (auto points = dynamic_cast<const PointGeography*>(&geog)) {
+    int64_t n = points->Points().size();
+    int64_t point_size = 1 + sizeof(uint32_t) + kCoordSize;
+    return n <= 1 ? point_size : kHeaderSize + n * point_size;
+  } else if (auto polylines = dynamic_cast<const PolylineGeography*>(&geog)) {
+    const auto& parts = polylines->Polylines();
+    if (parts.size() == 1) {
+      return kHeaderSize + parts[0]->num_vertices() * kCoordSize;
+    }
+
+    int64_t size = kHeaderSize;
+    for (const auto& polyline : parts) {
+      size += kHeaderSize + polyline->num_vertices() * kCoordSize;
+    }
+    return size;
+  } else if (auto polygon = dynamic_cast<const PolygonGeography*>(&geog)) {
+    const S2Polygon& poly = *polygon->Polygon();
+    std::vector<int> shells = ShellLoops(poly);
+    if (shells.size() == 1) {
+      return ShellSize(poly, shells[0]);
+    }
+
+    int64_t size = kHeaderSize;
+    for (int loop_start : shells) {
+      size += ShellSize(poly, loop_start);
+    }
+    return size;
+  } else if (auto polylines = dynamic_cast<const LaxPolylineGeography*>(&geog)) {
+    const auto& parts = polylines->Polylines();
+    if (parts.size() == 1) {
+      return kHeaderSize + parts[0]->num_vertices() * kCoordSize;
+    }
+
+    int64_t size = kHeaderSize;
+    for (const auto& polyline : parts) {
+      size += kHeaderSize + polyline->num_vertices() * kCoordSize;
+    }
+    return size;
+  } else if (auto polygon = dynamic_cast<const LaxPolygonGeography*>(&geog)) {
+    const S2LaxPolygonShape& poly = *polygon->Polygon();
+    const std::vector<int>& offsets = polygon->LoopOffsets();
+    if (polygon->num_polygons() == 1) {
+      return LaxShellSize(poly, offsets[0], offsets[1]);
+    }
+
+    int64_t size = kHeaderSize;
+    for (int i = 0; i < polygon->num_polygons(); i++) {
+      size += LaxShellSize(poly, offsets[i], offsets[i + 1]);
+    }
+    return size;
+  } else if (auto collection = dynamic_cast<const GeographyCollection*>(&geog)) {
+    int64_t size = kHeaderSize;
+    for (const auto& feature : collection->Features()) {
+      size += SizeOf(*feature);
+    }
+    return size;
+  } else {
+    throw Exception("Can't write unsupported Geography subclass as WKB");
+  }
+}
+
+void WKBWriter::WriteFeature(const Geography& geog, uint8_t* out) {
+  out_ = out;
+  WriteGeography(geog);
+}
+
+void WKBWriter::WriteGeography(const Geography& geog) {
+  if (auto points = dynamic_cast<const PointGeography*>(&geog)) {
+    WritePoints(*points);
+  } else if (auto polylines = dynamic_cast<const PolylineGeography*>(&geog)) {
+    WritePolylines(*polylines);
+  } else if (auto polygon = dynamic_cast<const PolygonGeography*>(&geog)) {
+    WritePolygon(*polygon);
+  } else if (auto polylines = dynamic_cast<const LaxPolylineGeography*>(&geog)) {
+    WritePolylines(*polylines);
+  } else if (auto polygon = dynamic_cast<const LaxPolygonGeography*>(&geog)) {
+    WritePolygon(*polygon);
+  } else if (auto collection = dynamic_cast<const GeographyCollection*>(&geog)) {
+    WriteCollection(*collection);
+  } else {
+    throw Exception("Can't write unsupported Geography subclass as WKB");
+  }
+}
+
+void WKBWriter::WritePoints(const PointGeography& geog) {
+  const std::vector<S2Point>& points = geog.Points();
+  if (points.empty()) {
+    WriteHeader(util::GeometryType::POINT);
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    WriteDouble(nan);
+    WriteDouble(nan);
+  } else if (points.size() == 1) {
+    WriteHeader(util::GeometryType::POINT);
+    WriteCoords(points.data(), 1);
+  } else {
+    WriteHeader(util::GeometryType::MULTIPOINT);
+    WriteUInt32(points.size());
+    for (const S2Point& point : points) {
+      WriteHeader(util::GeometryType::POINT);
+      WriteCoords(&point, 1);
+    }
+  }
+}
+
+void WKBWriter::WritePolylines(const PolylineGeography& geog) {
+  const auto& parts = geog.Polylines();
+  if (parts.size() == 1) {
+    WriteHeader(util::GeometryType::LINESTRING);
+    WriteUInt32(parts[0]->num_vertices());
+    if (parts[0]->num_vertices() > 0) {
+      WriteCoords(&parts[0]->vertex(0), parts[0]->num_vertices());
+    }
+    return;
+  }
+
+  if (parts.empty()) {
+    WriteHeader(util::GeometryType::LINESTRING);
+  } else {
+    WriteHeader(util::GeometryType::MULTILINESTRING);
+  }
+
+  WriteUInt32(parts.size());
+  for (const auto& polyline : parts) {
+    WriteHeader(util::GeometryType::LINESTRING);
+    WriteUInt32(polyline->num_vertices());
+    if (polyline->num_vertices() > 0) {
+      WriteCoords(&polyline->vertex(0), polyline->num_vertices());
+    }
+  }
+}
+
+void WKBWriter::WritePolygon(const PolygonGeography& geog) {
+  const S2Polygon& polygon = *geog.Polygon();
+  std::vector<int> shells = ShellLoops(polygon);
+  if (shells.size() == 1) {
+    WriteShell(polygon, shells[0]);
+    return;
+  }
+
+  if (shells.empty()) {
+    WriteHeader(util::GeometryType::POLYGON);
+  } else {
+    WriteHeader(util::GeometryType::MULTIPOLYGON);
+  }
+
+  WriteUInt32(shells.size());
+  for (int loop_start : shells) {
+    WriteShell(polygon, loop_start);
+  }
+}
+
+void WKBWriter::WritePolylines(const LaxPolylineGeography& geog) {
+  const auto& parts = geog.Polylines();
+  if (parts.size() == 1) {
+    WriteHeader(util::GeometryType::LINESTRING);
+    WriteUInt32(parts[0]->num_vertices());
+    if (parts[0]->num_vertices() > 0) {
+      WriteCoords(&parts[0]->vertex(0), parts[0]->num_vertices());
+    }
+    return;
+  }
+
+  if (parts.empty()) {
+    WriteHeader(util::GeometryType::LINESTRING);
+  } else {
+    WriteHeader(util::GeometryType::MULTILINESTRING);
+  }
+
+  WriteUInt32(parts.size());
+  for (const auto& polyline : parts) {
+    WriteHeader(util::GeometryType::LINESTRING);
+    WriteUInt32(polyline->num_vertices());
+    if (polyline->num_vertices() > 0) {
+      WriteCoords(&polyline->vertex(0), polyline->num_vertices());
+    }
+  }
+}
+
+// Lax shells and holes already have the orientation that is written (i.e.,
+// counter-clockwise shells and clockwise holes)
+void WKBWriter::WritePolygon(const LaxPolygonGeography& geog) {
+  const S2LaxPolygonShape& polygon = *geog.Polygon();
+  const std::vector<int>& offsets = geog.LoopOffsets();
+  if (geog.num_polygons() == 1) {
+    WriteLaxShell(polygon, offsets[0], offsets[1]);
+    return;
+  }
+
+  if (geog.num_polygons() == 0) {
+    WriteHeader(util::GeometryType::POLYGON);
+  } else {
+    WriteHeader(util::GeometryType::MULTIPOLYGON);
+  }
+
+  WriteUInt32(geog.num_polygons());
+  for (int i = 0; i < geog.num_polygons(); i++) {
+    WriteLaxShell(polygon, offsets[i], offsets[i + 1]);
+  }
+}
+
+void WKBWriter::WriteCollection(const GeographyCollection& geog) {
+  WriteHeader(util::GeometryType::GEOMETRYCOLLECTION);
+  WriteUInt32(geog.Features().size());
+  for (const auto& feature : geog.Features()) {
+    WriteGeography(*feature);
+  }
+}
+
+void WKBWriter::WriteShell(const S2Polygon& polygon, int loop_start) {
+  uint32_t num_rings = 0;
+  ForEachRing(polygon, loop_start, [&](const S2Loop* loop) { num_rings++; });
+
+  WriteHeader(util::GeometryType::POLYGON);
+  WriteUInt32(num_rings);
+
+  const S2Loop* shell = polygon.loop(loop_start);
+  ForEachRing(polygon, loop_start, [&](const S2Loop* loop) {
+    int n = loop->num_vertices();
+    if (n == 0) {
+      throw Exception("Unexpected S2Loop with 0 vertices");
+    }
+
+    WriteUInt32(n + 1);
+
+    // holes are written in the reverse order to give them a clockwise
+    // orientation
+    if (loop == shell) {
+      WriteCoords(&loop->vertex(0), n);
+      WriteCoords(&loop->vertex(0), 1);
+    } else {
+      scratch_.clear();
+      for (int i = n - 1; i >= 0; i--) {
+        scratch_.push_back(loop->vertex(i));
+      }
+      scratch_.push_back(loop->vertex(n - 1));
+      WriteCoords(scratch_.data(), n + 1);
+    }
+  });
+}
+
+void WKBWriter::WriteLaxShell(const S2LaxPolygonShape& polygon, int loop_begin,
+                              int loop_end) {
+  WriteHeader(util::GeometryType::POLYGON);
+  WriteUInt32(loop_end - loop_begin);
+  for (int i = loop_begin; i < loop_end; i++) {
+    int n = polygon.num_loop_vertices(i);
+    if (n == 0) {
+      throw Exception("Unexpected S2LaxPolygonShape loop with 0 vertices");
+    }
+
+    WriteUInt32(n + 1);
+    WriteCoords(&polygon.loop_vertex(i, 0), n);
+    WriteCoords(&polygon.loop_vertex(i, 0), 1);
+  }
+}
+
+void WKBWriter::WriteCoords(const S2Point* points, int64_t n) {
+  if (plate_carree_scale_ != 0) {
+    for (int64_t i = 0; i < n; i++) {
+      WriteDouble(plate_carree_scale_ * S2LatLng::Longitude(points[i]).radians());
+      WriteDouble(plate_carree_scale_ * S2LatLng::Latitude(points[i]).radians());
+    }
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      R2Point projected = projection_->Project(points[i]);
+      WriteDouble(projected.x());
+      WriteDouble(projected.y());
+    }
+  }
+}
+
+void WKBWriter::WriteHeader(util::GeometryType geometry_type) {
+  *out_ = endian_;
+  out_++;
+  WriteUInt32(static_cast<uint32_t>(geometry_type));
+}
+
+void WKBWriter::WriteUInt32(uint32_t value) {
+  if (swap_endian_) {
+    value = SwapUInt32(value);
+  }
+
+  memcpy(out_, &value, sizeof(uint32_t));
+  out_ += sizeof(uint32_t);
+}
+
+void WKBWriter::WriteDouble(double value) {
+  if (swap_endian_) {
+    SwapDouble(&value);
+  }
+
+  memcpy(out_, &value, sizeof(double));
+  out_ += sizeof(double);
+}
+
+}  // namespace s2geography
@@ -0,0 +1,95 @@
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "constructor.h"
+#include "geography.h"
+
+namespace s2geography {
+
+// Thrown by the WKBReader when the bytes of a feature are not valid WKB (as
+// opposed to valid WKB that can't be constructed as a Geography)
+class WKBException : public Exception {
+ public:
+  WKBException(std::string what) : Exception(what) {}
+};
+
+// The WKBReader builds geographies from ISO or extended (PostGIS) well-known
+// binary. Coordinates are passed to a util::FeatureConstructor one
+// linestring or ring at a time, so the result is identical to building the
+// same features by handling the WKB with the wk package. Unlike the wk
+// handler, a WKBReader does not use the R API: several WKBReaders can read
+// features from the same input at once.
+class WKBReader {
+ public:
+  explicit WKBReader(const util::Constructor::Options& options);
+
+  // Builds the feature encoded by the size bytes at bytes or throws
+  // WKBException if the bytes are not valid WKB or Exception if the feature
+  // can't be constructed.
+  std::unique_ptr<Geography> ReadFeature(const uint8_t* bytes, int64_t size);
+
+ private:
+  util::FeatureConstructor constructor_;
+  const uint8_t* data_;
+  const uint8_t* end_;
+  bool swap_endian_;
+  std::vector<double> scratch_;
+
+  void ReadGeometry();
+  void ReadCoords(uint32_t n, int32_t coord_size);
+  uint8_t ReadUInt8();
+  uint32_t ReadUInt32();
+  void CheckAvailable(int64_t n);
+};
+
+// The WKBWriter encodes geographies as ISO well-known binary with the same
+// layout as the wk package's wkb_writer() when handling the geography using
+// the exporter used by s2_as_binary(): single points, polylines, and
+// polygons are written as simple geometries, polygon shells are written
+// counter-clockwise and holes clockwise with the first vertex repeated at the
+// end, and empty points are written with nan coordinates. Lax polylines and
+// polygons are written using the same layout. The exact size of
+// each feature is computed up front so that the output can be allocated once
+// and written without resizing. Like the WKBReader, several WKBWriters can
+// write features at once.
+class WKBWriter {
+ public:
+  // The projection in options is required; endian is 1 for little endian
+  // output or 0 for big endian output.
+  WKBWriter(const util::Constructor::Options& options, uint8_t endian);
+
+  // Returns the number of bytes needed to encode geog.
+  int64_t SizeOf(const Geography& geog) const;
+
+  // Writes exactly SizeOf(geog) bytes to out or throws Exception if geog
+  // is not a supported Geography subclass.
+  void WriteFeature(const Geography& geog, uint8_t* out);
+
+ private:
+  S2::Projection* projection_;
+  double plate_carree_scale_;
+  uint8_t endian_;
+  bool swap_endian_;
+  uint8_t* out_;
+  std::vector<S2Point> scratch_;
+
+  void WritePoints(const PointGeography& geog);
+  void WritePolylines(const PolylineGeography& geog);
+  void WritePolygon(const PolygonGeography& geog);
+  void WritePolylines(const LaxPolylineGeography& geog);
+  void WritePolygon(const LaxPolygonGeography& geog);
+  void WriteCollection(const GeographyCollection& geog);
+  void WriteGeography(const Geography& geog);
+  void WriteShell(const S2Polygon& polygon, int loop_start);
+  void WriteLaxShell(const S2LaxPolygonShape& polygon, int loop_begin,
+                     int loop_end);
+  void WriteCoords(const S2Point* points, int64_t n);
+  void WriteHeader(util::GeometryType geometry_type);
+  void WriteUInt32(uint32_t value);
+  void WriteDouble(double value);
+};
+
+}  // namespace s2geography